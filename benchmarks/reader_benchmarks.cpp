@@ -0,0 +1,728 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "reader.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+#include "char_class.hpp"
+#include "parallel_lexer.hpp"
+#include "relexer.hpp"
+#include "source_manager.hpp"
+#include "token_cache.hpp"
+#include "uring_source.hpp"
+
+/// The data/*.qc corpus concatenated and repeated until it reaches @p bytes.
+static std::string make_corpus(const size_t bytes) {
+    std::string sample;
+    for (int i = 0; i < 12; ++i) {
+        std::ostringstream path;
+        path << QPILER_DATA_DIR << "/test" << std::setfill('0') << std::setw(2)
+             << i << ".qc";
+        std::ifstream ifs(path.str(), std::ios::binary);
+        sample.append(std::istreambuf_iterator<char>(ifs), {});
+        sample += '\n';
+    }
+    std::string corpus;
+    corpus.reserve(bytes + sample.size());
+    while (corpus.size() < bytes) {
+        corpus += sample;
+    }
+    return corpus;
+}
+
+/// Deeply indented generated code, where most bytes are whitespace.
+static std::string make_indented(const size_t bytes) {
+    std::string corpus;
+    corpus.reserve(bytes + 256);
+    for (size_t i = 0; corpus.size() < bytes; ++i) {
+        corpus.append(4 * (i % 24), ' ');
+        corpus += "generated_value_" + std::to_string(i) + " = "
+            + std::to_string(i * 7919) + ";\n";
+    }
+    return corpus;
+}
+
+/// Dict literals in the style of data/test04.qc with realistic string
+/// lengths, the occasional escape included.
+static std::string make_strings(const size_t bytes) {
+    std::string corpus;
+    corpus.reserve(bytes + 256);
+    for (size_t i = 0; corpus.size() < bytes; ++i) {
+        corpus += "{\"name_" + std::to_string(i)
+            + "\": 'a plain description of entry number "
+            + std::to_string(i) + "', \"path\": \"/usr/share/qpiler/"
+            + std::to_string(i * 31) + (i % 8 ? "\"" : "\\n\"") + "};\n";
+    }
+    return corpus;
+}
+
+/// Long doc blocks between short functions, like license headers and
+/// generated documentation.
+static std::string make_commented(const size_t bytes) {
+    std::string corpus;
+    corpus.reserve(bytes + 4096);
+    for (size_t i = 0; corpus.size() < bytes; ++i) {
+        corpus += "/*\n";
+        for (int j = 0; j < 40; ++j) {
+            corpus += " * Permission is hereby granted, free of charge, to any "
+                      "person\n";
+        }
+        corpus += " */\nf_" + std::to_string(i) + "(x) { return x; }\n";
+    }
+    return corpus;
+}
+
+/// Expression-heavy code, dense with multi-character operators.
+static std::string make_expressions(const size_t bytes) {
+    std::string corpus;
+    corpus.reserve(bytes + 256);
+    while (corpus.size() < bytes) {
+        corpus += "x<<=y>>2;a+=b&&c||d!=e;i++;j--;k->m>=n<=p;q%=r^=s|=t;\n";
+    }
+    return corpus;
+}
+
+/// Generated code with Cyrillic and CJK identifiers and strings.
+static std::string make_localized(const size_t bytes) {
+    std::string corpus;
+    corpus.reserve(bytes + 256);
+    for (size_t i = 0; corpus.size() < bytes; ++i) {
+        // счётчик_N = длина("строка") + 変数; // комментарий
+        corpus += "\xd1\x81\xd1\x87\xd1\x91\xd1\x82\xd1\x87\xd0\xb8"
+                  "\xd0\xba_"
+            + std::to_string(i)
+            + " = \xd0\xb4\xd0\xbb\xd0\xb8\xd0\xbd\xd0\xb0(\""
+              "\xd1\x81\xd1\x82\xd1\x80\xd0\xbe\xd0\xba\xd0\xb0\") + "
+              "\xe5\xa4\x89\xe6\x95\xb0; // \xd0\xba\xd0\xbe\xd0\xbc"
+              "\xd0\xbc\xd0\xb5\xd0\xbd\xd1\x82\xd0\xb0\xd1\x80\xd0"
+              "\xb8\xd0\xb9\n";
+    }
+    return corpus;
+}
+
+/// In-memory windows served with a fixed delay, like reads from a
+/// network-mounted volume.
+class slow_source final : public source {
+public:
+    slow_source(
+        const std::string& data, const size_t window,
+        const std::chrono::microseconds latency
+    )
+        : data(data)
+        , window(window)
+        , latency(latency) { }
+
+    std::string_view fetch(const std::streamoff offset) override {
+        std::this_thread::sleep_for(latency);
+        return std::string_view(data).substr(
+            std::min(static_cast<size_t>(offset), data.size()), window
+        );
+    }
+
+    [[nodiscard]] std::streamoff size() const noexcept override {
+        return static_cast<std::streamoff>(data.size());
+    }
+
+private:
+    const std::string& data;
+    size_t window;
+    std::chrono::microseconds latency;
+};
+
+template <typename Token>
+static size_t lex_all(reader& r) {
+    size_t tokens = 0;
+    Token t;
+    do {
+        r.next_token(t);
+        ++tokens;
+    } while (t.kind != token_kind::eof);
+    return tokens;
+}
+
+template <typename Token = token>
+static void lex_benchmark(
+    benchmark::State& state, const std::string& corpus,
+    const position_mode positions = position_mode::tracked
+) {
+    size_t tokens = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string data = corpus;
+        reader r { data };
+        state.ResumeTiming();
+        r.set_position_mode(positions); // the newline index is timed too
+        tokens += lex_all<Token>(r);
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+    state.counters["tokens"] = benchmark::Counter(
+        static_cast<double>(tokens), benchmark::Counter::kIsRate
+    );
+}
+
+static void BM_LexCorpus(benchmark::State& state) {
+    lex_benchmark(
+        state, make_corpus(static_cast<size_t>(state.range(0)) << 20)
+    );
+}
+
+BENCHMARK(BM_LexCorpus)->Arg(1)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_LexIndented(benchmark::State& state) {
+    lex_benchmark(
+        state, make_indented(static_cast<size_t>(state.range(0)) << 20)
+    );
+}
+
+BENCHMARK(BM_LexIndented)->Arg(16)->Unit(benchmark::kMillisecond);
+
+/// BM_LexIndented with offsets only and a newline index built per window.
+static void BM_LexIndentedOffsets(benchmark::State& state) {
+    lex_benchmark(
+        state, make_indented(static_cast<size_t>(state.range(0)) << 20),
+        position_mode::offsets
+    );
+}
+
+BENCHMARK(BM_LexIndentedOffsets)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_LexStrings(benchmark::State& state) {
+    lex_benchmark(
+        state, make_strings(static_cast<size_t>(state.range(0)) << 20)
+    );
+}
+
+BENCHMARK(BM_LexStrings)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_LexComments(benchmark::State& state) {
+    lex_benchmark(
+        state, make_commented(static_cast<size_t>(state.range(0)) << 20)
+    );
+}
+
+BENCHMARK(BM_LexComments)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_LexOperators(benchmark::State& state) {
+    lex_benchmark(
+        state, make_expressions(static_cast<size_t>(state.range(0)) << 20)
+    );
+}
+
+BENCHMARK(BM_LexOperators)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_LexLocalized(benchmark::State& state) {
+    lex_benchmark(
+        state, make_localized(static_cast<size_t>(state.range(0)) << 20)
+    );
+}
+
+BENCHMARK(BM_LexLocalized)->Arg(16)->Unit(benchmark::kMillisecond);
+
+/// Same corpus as BM_LexCorpus, with token text borrowed from the source.
+static void BM_LexViews(benchmark::State& state) {
+    lex_benchmark<token_view>(
+        state, make_corpus(static_cast<size_t>(state.range(0)) << 20)
+    );
+}
+
+BENCHMARK(BM_LexViews)->Arg(16)->Unit(benchmark::kMillisecond);
+
+/// BM_LexViews with every keyword interned into a symbol_table.
+static void BM_LexSymbols(benchmark::State& state) {
+    const auto corpus = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string data = corpus;
+        symbol_table table;
+        reader r { data };
+        state.ResumeTiming();
+        r.intern_symbols(&table);
+        benchmark::DoNotOptimize(lex_all<token_view>(r));
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+}
+
+BENCHMARK(BM_LexSymbols)->Arg(16)->Unit(benchmark::kMillisecond);
+
+/// Same corpus as BM_LexCorpus, read into a token_batch of range(1) tokens
+/// per call instead of one token object per call.
+static void BM_LexBatch(benchmark::State& state) {
+    const auto corpus = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    const auto count = static_cast<size_t>(state.range(1));
+    size_t tokens = 0;
+    token_batch batch;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string data = corpus;
+        reader r { data };
+        state.ResumeTiming();
+        do {
+            tokens += r.next_tokens(batch, count);
+        } while (batch.kinds.back() != token_kind::eof);
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+    state.counters["tokens"] = benchmark::Counter(
+        static_cast<double>(tokens), benchmark::Counter::kIsRate
+    );
+}
+
+BENCHMARK(BM_LexBatch)
+    ->Args({ 16, 64 })
+    ->Args({ 16, 1024 })
+    ->Unit(benchmark::kMillisecond);
+
+/// The BM_LexCorpus input lexed by parallel_lexer on range(1) threads in
+/// 1 MiB chunks, collecting every token as BM_LexCollect does.
+static void BM_LexParallel(benchmark::State& state) {
+    const auto corpus = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    const parallel_lexer lexer { static_cast<size_t>(state.range(1)) };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lexer.lex(corpus).size());
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+}
+
+BENCHMARK(BM_LexParallel)
+    ->Args({ 16, 1 })
+    ->Args({ 16, 4 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/// Sequential baseline for BM_LexParallel: every token kept in a vector.
+static void BM_LexCollect(benchmark::State& state) {
+    const auto corpus = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string data = corpus;
+        reader r { data };
+        state.ResumeTiming();
+        std::vector<token> tokens;
+        do {
+            r.next_token(tokens.emplace_back());
+        } while (tokens.back().kind != token_kind::eof);
+        benchmark::DoNotOptimize(tokens.size());
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+}
+
+BENCHMARK(BM_LexCollect)->Arg(16)->Unit(benchmark::kMillisecond);
+
+/// One space typed into the middle of the BM_LexCollect input and deleted
+/// again, alternately, with the tokens brought up to date by relex().
+static void BM_Relex(benchmark::State& state) {
+    const auto corpus = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    const auto middle = static_cast<std::streamoff>(corpus.size() / 2);
+    auto edited = corpus;
+    edited.insert(static_cast<size_t>(middle), 1, ' ');
+    std::vector<token> tokens;
+    {
+        std::string data = corpus;
+        reader r { data };
+        do {
+            r.next_token(tokens.emplace_back());
+        } while (tokens.back().kind != token_kind::eof);
+    }
+    bool typed = false;
+    for (auto _ : state) {
+        typed = !typed;
+        tokens = typed
+            ? relex(edited, std::move(tokens), { { middle, 0, 1 } })
+            : relex(corpus, std::move(tokens), { { middle, 1, 0 } });
+        benchmark::DoNotOptimize(tokens.size());
+    }
+}
+
+BENCHMARK(BM_Relex)->Arg(16)->Unit(benchmark::kMillisecond);
+
+/// The BM_LexCollect input looked up in a token_cache: range(1) == 0 lexes
+/// and stores it on every iteration, otherwise every lookup hits.
+static void BM_TokenCache(benchmark::State& state) {
+    const auto corpus = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    const auto directory
+        = std::filesystem::temp_directory_path() / "qpiler_bench_cache";
+    std::filesystem::remove_all(directory);
+    token_cache cache { directory };
+    (void)cache.tokens_of(corpus);
+    for (auto _ : state) {
+        if (state.range(1) == 0) {
+            state.PauseTiming();
+            std::filesystem::remove_all(directory);
+            std::filesystem::create_directories(directory);
+            state.ResumeTiming();
+        }
+        const auto tokens = cache.tokens_of(corpus);
+        benchmark::DoNotOptimize(tokens.offset(tokens.size() / 2));
+    }
+    std::filesystem::remove_all(directory);
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+}
+
+BENCHMARK(BM_TokenCache)
+    ->Args({ 16, 0 })
+    ->Args({ 16, 1 })
+    ->Unit(benchmark::kMillisecond);
+
+/// Cost of one lexing error at the end of a range(0) MiB in-memory input:
+/// every iteration jumps to a malformed number and catches the error, and
+/// with range(1) != 0 also prints it.
+static void BM_ReaderError(benchmark::State& state) {
+    auto text = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    const auto bad = static_cast<std::streamoff>(text.size());
+    text += "0123";
+    reader r { std::make_shared<view_source>(text) };
+    token t;
+    for (auto _ : state) {
+        r.jump_to_position(bad, 0, 0);
+        try {
+            r.next_token(t);
+        } catch (const std::runtime_error& e) {
+            if (state.range(1) != 0) {
+                benchmark::DoNotOptimize(e.what());
+            }
+            benchmark::DoNotOptimize(&e);
+        }
+    }
+}
+
+BENCHMARK(BM_ReaderError)->Args({ 16, 0 })->Args({ 16, 1 });
+
+/// range(0) files of range(1) KiB each in one source_manager, with a
+/// random global offset mapped back to file, line and column per iteration.
+static void BM_LocateGlobal(benchmark::State& state) {
+    const auto files = static_cast<size_t>(state.range(0));
+    const auto file_size = static_cast<size_t>(state.range(1)) << 10;
+    const auto corpus = make_corpus(files * file_size);
+    source_manager sources;
+    for (size_t i = 0; i < files; ++i) {
+        sources.add_buffer(
+            "file" + std::to_string(i), corpus.substr(i * file_size, file_size)
+        );
+    }
+    const auto end = sources.to_global(
+        static_cast<file_id>(files - 1), static_cast<std::streamoff>(file_size)
+    );
+    for (file_id file = 0; file < files; ++file) {
+        (void)sources.locate(sources.base(file)); // count the lines up front
+    }
+    std::mt19937_64 random { 42 };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sources.locate(random() % end));
+    }
+}
+
+BENCHMARK(BM_LocateGlobal)->Args({ 4096, 16 });
+
+/// range(0) MiB in 64 KiB windows that take range(1) microseconds each to
+/// arrive, read directly (range(2) == 0) or through a readahead_source.
+static void BM_LexSlowSource(benchmark::State& state) {
+    const auto corpus = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    const std::chrono::microseconds latency { state.range(1) };
+    for (auto _ : state) {
+        source_ptr input
+            = std::make_shared<slow_source>(corpus, 64 << 10, latency);
+        if (state.range(2) != 0) {
+            input = std::make_shared<readahead_source>(std::move(input));
+        }
+        reader r { input };
+        benchmark::DoNotOptimize(lex_all<token>(r));
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+}
+
+BENCHMARK(BM_LexSlowSource)
+    ->Args({ 16, 500, 0 })
+    ->Args({ 16, 500, 1 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/// Buffer size sweep over a 32 MiB file: reads of range(0) bytes, fixed
+/// (range(1) == 0) or growing from there to default_max_buffer_size.
+static void BM_LexBufferSize(benchmark::State& state) {
+    const auto corpus = make_corpus(32 << 20);
+    const auto path
+        = std::filesystem::temp_directory_path() / "qpiler_sweep.qc";
+    std::ofstream(path, std::ios::binary) << corpus;
+    const auto buffer_size = static_cast<std::streamsize>(state.range(0));
+    const auto max_buffer_size
+        = state.range(1) != 0 ? default_max_buffer_size : buffer_size;
+    for (auto _ : state) {
+        reader r { path, read_mode::buffered, buffer_size, max_buffer_size };
+        benchmark::DoNotOptimize(lex_all<token>(r));
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_LexBufferSize)
+    ->ArgsProduct({ benchmark::CreateRange(1 << 10, 4 << 20, 4), { 0 } })
+    ->Args({ 4 << 10, 1 })
+    ->Unit(benchmark::kMillisecond);
+
+/// range(0) MiB piped in through a stream_source with 64 KiB reads, without
+/// (range(1) == 0) or with a spill file for jumps back.
+static void BM_LexStream(benchmark::State& state) {
+    const auto corpus = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    for (auto _ : state) {
+        std::istringstream in(corpus);
+        reader r { std::make_shared<stream_source>(
+            in, 64 << 10, state.range(1) != 0
+        ) };
+        benchmark::DoNotOptimize(lex_all<token>(r));
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+}
+
+BENCHMARK(BM_LexStream)
+    ->Args({ 16, 0 })
+    ->Args({ 16, 1 })
+    ->Unit(benchmark::kMillisecond);
+
+/// range(0) files of 64 KiB each, lexed one after another from buffered
+/// readers (range(1) == 0) or from one io_uring batch.
+static void BM_LexFileBatch(benchmark::State& state) {
+    const auto corpus = make_corpus(64 << 10);
+    const auto dir = std::filesystem::temp_directory_path() / "qpiler_batch";
+    std::filesystem::create_directories(dir);
+    std::vector<std::filesystem::path> paths;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        paths.push_back(dir / (std::to_string(i) + ".qc"));
+        std::ofstream(paths.back(), std::ios::binary) << corpus;
+    }
+    for (auto _ : state) {
+        std::vector<source_ptr> sources;
+        if (state.range(1) != 0) {
+            sources = open_uring_batch(paths, 16 << 10);
+        } else {
+            for (const auto& path : paths) {
+                sources.push_back(
+                    std::make_shared<file_source>(path, 16 << 10)
+                );
+            }
+        }
+        for (const auto& input : sources) {
+            reader r { input };
+            benchmark::DoNotOptimize(lex_all<token>(r));
+        }
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations()) * state.range(0)
+        * static_cast<int64_t>(corpus.size())
+    );
+    std::filesystem::remove_all(dir);
+}
+
+BENCHMARK(BM_LexFileBatch)
+    ->Args({ 256, 0 })
+    ->Args({ 256, 1 })
+    ->Unit(benchmark::kMillisecond);
+
+/// Re-expanding placeholders: 4096 jumps to token starts scattered over the
+/// first MiB of a 4 MiB file, lexing 32 tokens after each, read straight from
+/// a file_source (range(0) == 0) or through a 2 MiB block_cache_source.
+static void BM_LexJumps(benchmark::State& state) {
+    const auto corpus = make_corpus(4 << 20);
+    const auto path
+        = std::filesystem::temp_directory_path() / "qpiler_jumps.qc";
+    std::ofstream(path, std::ios::binary) << corpus;
+    std::vector<token> targets;
+    {
+        reader r { path };
+        token t;
+        for (r.next_token(t); t.file_offset < (1 << 20); r.next_token(t)) {
+            targets.push_back(t);
+        }
+    }
+    std::mt19937 random { 42 };
+    std::shuffle(targets.begin(), targets.end(), random);
+    targets.resize(std::min<size_t>(targets.size(), 4096));
+    for (auto _ : state) {
+        source_ptr input = std::make_shared<file_source>(path, 16 << 10);
+        if (state.range(0) != 0) {
+            input = std::make_shared<block_cache_source>(
+                std::move(input), 2 << 20, 16 << 10
+            );
+        }
+        reader r { input };
+        for (const auto& target : targets) {
+            token t;
+            r.jump_to_position(target.file_offset, target.line, target.column);
+            for (int i = 0; i < 32 && t.kind != token_kind::eof; ++i) {
+                r.next_token(t);
+            }
+            benchmark::DoNotOptimize(t.word.data());
+        }
+    }
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(targets.size())
+    );
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_LexJumps)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/// What grouper::peek used to do: build every token, drop the trivia.
+static void BM_LexFilterTrivia(benchmark::State& state) {
+    const auto corpus = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string data = corpus;
+        reader r { data };
+        state.ResumeTiming();
+        token_view t;
+        do {
+            r.next_token(t);
+        } while (t.kind != token_kind::eof);
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+}
+
+BENCHMARK(BM_LexFilterTrivia)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_LexSignificant(benchmark::State& state) {
+    const auto corpus = make_corpus(static_cast<size_t>(state.range(0)) << 20);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string data = corpus;
+        reader r { data };
+        state.ResumeTiming();
+        token_view t;
+        do {
+            r.next_significant_token(t);
+        } while (t.kind != token_kind::eof);
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+}
+
+BENCHMARK(BM_LexSignificant)->Arg(16)->Unit(benchmark::kMillisecond);
+
+/// The long-literal cases of reader_tests: 1024-digit numbers and a long
+/// multi-line comment, each lexed into an owning token.
+static void BM_LexLongLiterals(benchmark::State& state) {
+    std::string comment = "/*";
+    for (int i = 0; i < 64; ++i) {
+        comment += "// the quick brown fox jumps over the lazy dog \"\\/\n";
+    }
+    comment += "*/";
+    const std::vector<std::string> literals {
+        std::string(1024, '9'),
+        std::string(1022, '9') + ".0",
+        "0." + std::string(1022, '9'),
+        std::string(512, '9') + "." + std::string(511, '9') + "e+789",
+        comment,
+        "\"" + std::string(1024, 'x') + "\"",
+    };
+    size_t bytes = 0;
+    token t;
+    for (auto _ : state) {
+        for (const auto& literal : literals) {
+            std::string data = literal; // a memcpy, small next to lexing
+            reader r { data };
+            r.next_token(t);
+            benchmark::DoNotOptimize(t.word.data());
+            bytes += literal.size();
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+BENCHMARK(BM_LexLongLiterals);
+
+/// Per-byte classification through <cctype>, as the reader used to do it.
+static void BM_ClassifyCType(benchmark::State& state) {
+    const std::string corpus = make_corpus(1 << 20);
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (const char c : corpus) {
+            const auto u = static_cast<unsigned char>(c);
+            hits += std::isspace(u) || std::isalnum(u) || c == '_';
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+}
+
+BENCHMARK(BM_ClassifyCType);
+
+/// Per-byte classification through the constexpr char_table.
+static void BM_ClassifyTable(benchmark::State& state) {
+    const std::string corpus = make_corpus(1 << 20);
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (const char c : corpus) {
+            hits += is_space(c) || is_identifier(c);
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations())
+        * static_cast<int64_t>(corpus.size())
+    );
+}
+
+BENCHMARK(BM_ClassifyTable);
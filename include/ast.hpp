@@ -28,8 +28,14 @@
 #include <memory>
 #include <queue>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "number.hpp"
+#include "symbols.hpp"
+
+class line_index;
+
 enum class token_kind {
     eof,
     open_bracket,
@@ -50,17 +56,88 @@ struct token {
     int column;
     std::streamoff file_offset;
     std::string word;
-
+    number_value value; ///< Decoded literal of integer and floating tokens
+    keyword_kind keyword { keyword_kind::identifier }; ///< Reserved word
+    std::uint32_t symbol { no_symbol }; ///< Interned id of keyword tokens
+
+    token() = default;
+    token(const token& other) = default;
+    token(token&& other) noexcept = default;
+    token& operator=(const token& other) = default;
+    token& operator=(token&& other) noexcept = default;
     virtual ~token();
 
     virtual void dump(std::ostream& os, const std::string& prefix, bool is_last)
         const noexcept;
 
     void dump(std::ostream& os) const noexcept;
+
+    /// Dump with the position looked up from file_offset, for tokens read
+    /// in position_mode::offsets.
+    void dump(std::ostream& os, const line_index& lines) const noexcept;
 };
 
 using token_ptr = std::shared_ptr<token>;
 
+/**
+ * @brief Token whose text borrows from the reader's source when it can.
+ *
+ * @ref word either spans the source bytes or views @ref storage; copies and
+ * moves keep an owned view pointing at their own storage.
+ */
+struct token_view {
+    token_kind kind {};
+    int line { 0 };
+    int column { 0 };
+    std::streamoff file_offset {};
+    std::string_view word;
+    std::string storage;
+    number_value value; ///< Decoded literal of integer and floating tokens
+    keyword_kind keyword { keyword_kind::identifier }; ///< Reserved word
+    std::uint32_t symbol { no_symbol }; ///< Interned id of keyword tokens
+
+    token_view() = default;
+    token_view(const token_view& other);
+    token_view(token_view&& other) noexcept;
+    token_view& operator=(const token_view& other);
+    token_view& operator=(token_view&& other) noexcept;
+    ~token_view();
+
+    bool owns() const noexcept;
+
+    void dump(std::ostream& os, const std::string& prefix, bool is_last)
+        const noexcept;
+
+    void dump(std::ostream& os) const noexcept;
+
+    void dump(std::ostream& os, const line_index& lines) const noexcept;
+};
+
+/**
+ * @brief Structure-of-arrays token buffer filled by reader::next_tokens.
+ *
+ * Token i is described by the i-th element of every array. Lengths are raw
+ * byte extents in the source, quotes and escape sequences included, so the
+ * text of an in-memory source can be sliced back out with text().
+ */
+struct token_batch {
+    std::vector<token_kind> kinds;
+    std::vector<std::streamoff> offsets;
+    std::vector<std::streamoff> lengths;
+    std::vector<int> lines;
+    std::vector<int> columns;
+
+    size_t size() const noexcept;
+
+    bool empty() const noexcept;
+
+    void clear() noexcept;
+
+    void resize(size_t count);
+
+    std::string_view text(size_t index, std::string_view source) const;
+};
+
 struct ast_node {
     size_t fixed_size { 1 }, full_size { 1 };
     virtual ~ast_node();
@@ -81,7 +158,7 @@ struct ast_node {
 using ast_node_ptr = std::shared_ptr<ast_node>;
 
 struct token_node : ast_node {
-    token value;
+    token_view value;
     bool empty() const noexcept override;
 
     void dump(
@@ -101,6 +178,7 @@ struct group_node : ast_node {
         weights; /// node_size -> node_index
 
     bool placeholder { false };
+    std::shared_ptr<const void> keep_alive; /// source bytes token spans borrow
     void append(ast_node_ptr node);
     bool empty() const noexcept override;
     size_t size() const noexcept;
@@ -0,0 +1,202 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CHAR_CLASS_HPP
+#define CHAR_CLASS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Lexical classes a byte can belong to.
+ *
+ * Each class is a single bit so that one lookup in @ref char_table answers
+ * any combination of questions about a byte.
+ */
+enum class char_class : std::uint8_t {
+    whitespace = 1U << 0, ///< ' ', '\\t', '\\n', '\\v', '\\f', '\\r'
+    identifier_start = 1U << 1, ///< Letter or '_', see make_char_table()
+    identifier = 1U << 2, ///< identifier_start, digit or UTF-8 continuation
+    digit = 1U << 3, ///< '0'-'9'
+    hex_digit = 1U << 4, ///< '0'-'9', 'a'-'f', 'A'-'F'
+    bracket = 1U << 5, ///< One of '(', ')', '[', ']', '{', '}'
+    separator = 1U << 6, ///< One of ',', ';', ':'
+    quote = 1U << 7 ///< '"' or '\''
+};
+
+/**
+ * @brief True for a code point beyond ASCII that identifiers may hold.
+ *
+ * That is any but U+0080 to U+00BF (controls, no-break space, Latin-1
+ * punctuation), the multiplication and division signs, U+2000 to U+303F
+ * (punctuation and symbol blocks, the ideographic space and brackets) save
+ * the CJK iteration marks and ideographic zero, the fullwidth forms of
+ * ASCII punctuation and U+FEFF, the byte order mark.
+ */
+constexpr bool is_identifier_code_point(const char32_t cp) noexcept {
+    if (cp <= 0xBF || cp == 0xD7 || cp == 0xF7 || cp == 0xFEFF) {
+        return false;
+    }
+    if (cp >= 0x2000 && cp <= 0x303F) {
+        return cp >= 0x3005 && cp <= 0x3007;
+    }
+    if (cp >= 0xFF00 && cp <= 0xFF65) {
+        // fullwidth digits, letters and low line
+        return (cp >= 0xFF10 && cp <= 0xFF19) || (cp >= 0xFF21 && cp <= 0xFF3A)
+            || (cp >= 0xFF41 && cp <= 0xFF5A) || cp == 0xFF3F;
+    }
+    return true;
+}
+
+/// The UTF-8 byte order mark, U+FEFF.
+inline constexpr std::string_view byte_order_mark = "\xEF\xBB\xBF";
+
+/**
+ * @brief Build the classification table at compile time.
+ *
+ * For ASCII this mirrors the "C" locale behaviour of the <cctype>
+ * predicates the reader used before, without the locale lookup and the
+ * out-of-line call. Beyond ASCII, a lead byte is classed as identifier
+ * when every code point it starts passes is_identifier_code_point(), so
+ * the check mostly needs one byte. Lead bytes 0xC3, 0xE3 and 0xEF start
+ * both kinds and are left to utf8_identifier_length(), as are those that
+ * never start an identifier or valid UTF-8 at all.
+ */
+consteval std::array<std::uint8_t, 256> make_char_table() noexcept {
+    std::array<std::uint8_t, 256> table {};
+    auto set = [&table](const char c, const char_class k) {
+        table[static_cast<unsigned char>(c)] |= static_cast<std::uint8_t>(k);
+    };
+    for (const char c : { ' ', '\t', '\n', '\v', '\f', '\r' }) {
+        set(c, char_class::whitespace);
+    }
+    for (char c = 'a'; c <= 'z'; ++c) {
+        for (const char letter : { c, static_cast<char>(c - 'a' + 'A') }) {
+            set(letter, char_class::identifier_start);
+            set(letter, char_class::identifier);
+            if (c <= 'f') {
+                set(letter, char_class::hex_digit);
+            }
+        }
+    }
+    set('_', char_class::identifier_start);
+    set('_', char_class::identifier);
+    for (int byte = 0x80; byte <= 0xF4; ++byte) {
+        const auto c = static_cast<char>(byte);
+        if (byte <= 0xBF) {
+            set(c, char_class::identifier); // continuation
+        } else if (byte >= 0xC4 && byte != 0xE2 && byte != 0xE3
+                   && byte != 0xEF) {
+            set(c, char_class::identifier_start);
+            set(c, char_class::identifier);
+        }
+    }
+    for (char c = '0'; c <= '9'; ++c) {
+        set(c, char_class::identifier);
+        set(c, char_class::digit);
+        set(c, char_class::hex_digit);
+    }
+    for (const char c : { '(', ')', '[', ']', '{', '}' }) {
+        set(c, char_class::bracket);
+    }
+    for (const char c : { ',', ';', ':' }) {
+        set(c, char_class::separator);
+    }
+    set('"', char_class::quote);
+    set('\'', char_class::quote);
+    return table;
+}
+
+/// Per-byte bit set of @ref char_class flags, shared by all scanners.
+inline constexpr std::array<std::uint8_t, 256> char_table = make_char_table();
+
+constexpr bool has_class(const char c, const char_class k) noexcept {
+    return (char_table[static_cast<unsigned char>(c)]
+            & static_cast<std::uint8_t>(k))
+        != 0;
+}
+
+constexpr bool is_space(const char c) noexcept {
+    return has_class(c, char_class::whitespace);
+}
+
+constexpr bool is_identifier_start(const char c) noexcept {
+    return has_class(c, char_class::identifier_start);
+}
+
+constexpr bool is_identifier(const char c) noexcept {
+    return has_class(c, char_class::identifier);
+}
+
+constexpr bool is_digit(const char c) noexcept {
+    return has_class(c, char_class::digit);
+}
+
+constexpr bool is_hex_digit(const char c) noexcept {
+    return has_class(c, char_class::hex_digit);
+}
+
+/// True for the lead byte of a multi-byte UTF-8 sequence.
+constexpr bool is_utf8_lead(const char c) noexcept {
+    return static_cast<unsigned char>(c) >= 0xC0;
+}
+
+/// True for a UTF-8 continuation byte, 10xxxxxx.
+constexpr bool is_utf8_continuation(const char c) noexcept {
+    return (static_cast<unsigned char>(c) & 0xC0U) == 0x80U;
+}
+
+/**
+ * @brief Length of the multi-byte UTF-8 sequence starting @p text when it
+ * encodes a code point identifiers may hold, or 0.
+ *
+ * This settles the lead bytes @ref char_table leaves open. A sequence that
+ * is cut short or malformed gives 0 too; the UTF-8 check reports it.
+ */
+constexpr size_t utf8_identifier_length(const std::string_view text) noexcept {
+    if (text.empty()) {
+        return 0;
+    }
+    const auto lead = static_cast<unsigned char>(text[0]);
+    const size_t length = lead < 0xC2 ? 0
+        : lead < 0xE0                 ? 2
+        : lead < 0xF0                 ? 3
+        : lead < 0xF5                 ? 4
+                                      : 0;
+    if (length == 0 || text.size() < length) {
+        return 0;
+    }
+    char32_t cp = lead & (0x7FU >> length);
+    for (size_t i = 1; i < length; ++i) {
+        if (!is_utf8_continuation(text[i])) {
+            return 0;
+        }
+        cp = cp << 6 | (static_cast<unsigned char>(text[i]) & 0x3FU);
+    }
+    return is_identifier_code_point(cp) ? length : 0;
+}
+
+#endif // CHAR_CLASS_HPP
@@ -0,0 +1,153 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DIAGNOSTICS_HPP
+#define DIAGNOSTICS_HPP
+
+#include <array>
+#include <cstdint>
+#include <ios>
+#include <memory>
+#include <ostream>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "line_index.hpp"
+
+/**
+ * @brief What went wrong while reading.
+ */
+enum class diagnostic_kind : std::uint8_t {
+    missing_comment_end, ///< A block comment runs to the end of input
+    missing_quote, ///< A string literal runs to the end of input
+    invalid_unicode_escape, ///< \\u not followed by four hex digits
+    invalid_escape, ///< Backslash before a character with no meaning
+    leading_zeros, ///< A number starting with 0 followed by a digit
+    expected_digit, ///< A number with no digits
+    digit_after_decimal, ///< A decimal point followed by no digit
+    digit_after_exponent, ///< An exponent with no digits
+    invalid_utf8, ///< A malformed UTF-8 sequence
+    position_out_of_range, ///< A jump outside the source
+    interrupted ///< Reading stopped before the end of input
+};
+
+/// Fixed text describing @p kind.
+[[nodiscard]] std::string_view describe(diagnostic_kind kind) noexcept;
+
+/**
+ * @brief Up to 80 bytes of the line around a diagnostic, copied when it
+ * is raised so that it can be shown after the source is gone.
+ */
+struct source_excerpt {
+    std::array<char, 80> bytes {};
+    std::uint8_t length { 0 };
+    std::uint8_t caret { 0 }; ///< Index of the offending byte in bytes
+
+    [[nodiscard]] std::string_view text() const noexcept;
+};
+
+/**
+ * @brief One problem found in the input.
+ *
+ * Raising one costs no more than filling these fields; the message and the
+ * excerpt are put together only by render().
+ */
+struct diagnostic {
+    diagnostic_kind kind {};
+    std::streamoff offset { 0 }; ///< Byte the problem was found at
+    text_position position { -1, -1 }; ///< Zero-based; -1 when unknown
+    source_excerpt excerpt;
+    std::source_location origin; ///< Code that raised it
+
+    /// One line "line L, column C (offset O): message", then the excerpt
+    /// with a caret under the offending byte.
+    void render(std::ostream& os) const;
+};
+
+/**
+ * @brief Exception carrying a diagnostic.
+ *
+ * It is a std::runtime_error whose what() renders the diagnostic on first
+ * call, prefixed with "[Reader-Error]", and keeps the text for later calls.
+ * Rendering happens exactly once, so what() may be called from several
+ * threads at a time, as on an exception rethrown from a worker; copies
+ * share the rendered text.
+ */
+class diagnostic_error : public std::runtime_error {
+public:
+    explicit diagnostic_error(const diagnostic& info);
+
+    [[nodiscard]] const char* what() const noexcept override;
+
+    [[nodiscard]] const diagnostic& info() const noexcept;
+
+private:
+    struct rendering;
+
+    diagnostic details;
+    std::shared_ptr<rendering> rendered;
+};
+
+/**
+ * @brief Diagnostics gathered from several reads, reported together.
+ *
+ * collect() runs a read and keeps the diagnostic it throws, so one bad
+ * input does not hide the problems of the next ones.
+ */
+class diagnostic_batch {
+public:
+    void add(const diagnostic& item);
+
+    /// Run @p action; returns false and keeps the diagnostic if it throws
+    /// a diagnostic_error. Other exceptions propagate.
+    template <typename Action> bool collect(Action&& action) {
+        try {
+            std::forward<Action>(action)();
+            return true;
+        } catch (const diagnostic_error& e) {
+            add(e.info());
+            return false;
+        }
+    }
+
+    [[nodiscard]] bool empty() const noexcept;
+
+    [[nodiscard]] size_t size() const noexcept;
+
+    [[nodiscard]] const std::vector<diagnostic>& items() const noexcept;
+
+    /// Render every diagnostic, in the order they were added.
+    void render(std::ostream& os) const;
+
+    void clear() noexcept;
+
+private:
+    std::vector<diagnostic> list;
+};
+
+#endif // DIAGNOSTICS_HPP
@@ -37,7 +37,9 @@ private:
     reader& src;
     size_t limit;
 
-    [[nodiscard]] token peek() const;
+    [[nodiscard]] group_ptr make_group() const;
+
+    void peek(token_view& current) const;
 
     [[nodiscard]] std::runtime_error make_error(
         const std::string& message,
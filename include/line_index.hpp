@@ -0,0 +1,67 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LINE_INDEX_HPP
+#define LINE_INDEX_HPP
+
+#include <ios>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Zero-based line and column of a byte offset.
+ */
+struct text_position {
+    int line; ///< Number of '\n' bytes before the offset
+    int column; ///< Bytes between the last '\n' and the offset
+};
+
+/**
+ * @brief Offsets of every line start of a source, for offset to
+ * line/column queries in O(log n).
+ *
+ * Text is added window by window in source order. Windows may overlap what
+ * is already indexed, so re-reading a window is harmless, but they must not
+ * leave a gap.
+ */
+class line_index {
+public:
+    void add(std::string_view text, std::streamoff offset);
+
+    /// Offset one past the last indexed byte.
+    [[nodiscard]] std::streamoff indexed_end() const noexcept;
+
+    /// Number of lines started so far; at least 1.
+    [[nodiscard]] size_t line_count() const noexcept;
+
+    /// Position of @p offset, which must not be negative. Offsets past
+    /// indexed_end() are placed on the last indexed line.
+    [[nodiscard]] text_position locate(std::streamoff offset) const;
+
+private:
+    std::vector<std::streamoff> line_starts { 0 };
+    std::streamoff end { 0 };
+};
+
+#endif // LINE_INDEX_HPP
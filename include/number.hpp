@@ -0,0 +1,76 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NUMBER_HPP
+#define NUMBER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+/**
+ * @brief Exact value of a numeric literal too large or too precise for the
+ * machine types: significand * 10^exponent.
+ *
+ * The significand is kept in binary, base 2^32 limbs, so a 1024-digit
+ * literal takes about 430 bytes instead of its text. Trailing zeros of the
+ * digits are folded into the exponent, which makes equal values compare
+ * equal.
+ */
+struct big_number {
+    std::vector<std::uint32_t> limbs; ///< Least significant limb first
+    std::int64_t exponent { 0 }; ///< Power of ten the significand scales by
+
+    /// Value of a literal the reader accepted as integer or floating.
+    static big_number parse(std::string_view literal);
+
+    /// Significand in decimal, followed by "e" and the exponent if nonzero.
+    [[nodiscard]] std::string to_string() const;
+
+    bool operator==(const big_number& other) const = default;
+};
+
+/**
+ * @brief Decoded value of a numeric token.
+ *
+ * std::monostate for tokens that are not numbers, std::int64_t for integer
+ * literals that fit, double for floating literals within its range, and a
+ * shared big_number for everything else, so copying a token stays cheap.
+ */
+using number_value = std::variant<
+    std::monostate, std::int64_t, double, std::shared_ptr<const big_number>>;
+
+/**
+ * @brief Decode the text of an integer (@p floating false) or floating
+ * literal.
+ *
+ * Machine-size values go through std::from_chars; literals it reports as
+ * out of range, overflow and underflow alike, fall back to big_number.
+ */
+number_value decode_number(std::string_view literal, bool floating);
+
+#endif // NUMBER_HPP
@@ -0,0 +1,129 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OPERATORS_HPP
+#define OPERATORS_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+/// Operators the reader munches into one special_character token. Every
+/// prefix of an operator must be an operator too, so the longest match is
+/// simply where the DFA stops.
+inline constexpr std::array<std::string_view, 37> operator_spellings {
+    "!",  "%",  "&",  "*",  "+",  "-",  ".",  "/",   "<",  "=",
+    ">",  "?",  "^",  "|",  "~",  "!=", "%=", "&&",  "&=", "*=",
+    "**", "++", "+=", "--", "-=", "->", "/=", "<<",  "<=", "==",
+    ">=", ">>", "^=", "|=", "||", "<<=", ">>="
+};
+
+/**
+ * @brief DFA over operator bytes, built at compile time from
+ * @ref operator_spellings.
+ *
+ * State 0 is dead and state 1 is the start; every other state is the
+ * operator spelled by the path to it. Bytes are first mapped to a column,
+ * 0 for bytes that appear in no operator, which keeps the transition table
+ * a few hundred bytes.
+ */
+struct operator_dfa {
+    static constexpr size_t max_states = 40;
+    static constexpr size_t max_columns = 20;
+
+    std::array<std::uint8_t, 256> columns {};
+    std::array<std::array<std::uint8_t, max_columns>, max_states> next {};
+    size_t states { 2 };
+
+    /// State after @p c from @p state; 0 when no operator continues so.
+    [[nodiscard]] constexpr std::uint8_t
+    step(const std::uint8_t state, const char c) const noexcept {
+        return next[state][columns[static_cast<unsigned char>(c)]];
+    }
+};
+
+consteval operator_dfa make_operator_dfa() {
+    operator_dfa dfa;
+    size_t used_columns = 1;
+    for (const auto spelling : operator_spellings) {
+        std::uint8_t state = 1;
+        for (const char c : spelling) {
+            auto& column = dfa.columns[static_cast<unsigned char>(c)];
+            if (column == 0) {
+                column = static_cast<std::uint8_t>(used_columns++);
+            }
+            auto& target = dfa.next[state][column];
+            if (target == 0) {
+                target = static_cast<std::uint8_t>(dfa.states++);
+            }
+            state = target;
+        }
+    }
+    if (used_columns > operator_dfa::max_columns
+        || dfa.states > operator_dfa::max_states) {
+        throw "operator_dfa is too small for operator_spellings";
+    }
+    return dfa;
+}
+
+/// The reader's operator automaton.
+inline constexpr operator_dfa operators = make_operator_dfa();
+
+/// Length of the longest operator at the start of @p text, 0 if none.
+constexpr size_t span_operator(const std::string_view text) noexcept {
+    std::uint8_t state = 1;
+    size_t length = 0;
+    while (length < text.size()) {
+        state = operators.step(state, text[length]);
+        if (state == 0) {
+            break;
+        }
+        ++length;
+    }
+    return length;
+}
+
+static_assert(
+    [] {
+        for (const auto spelling : operator_spellings) {
+            // prefix-closed: each proper prefix is a spelling as well
+            for (size_t n = 1; n < spelling.size(); ++n) {
+                bool found = false;
+                for (const auto other : operator_spellings) {
+                    found = found || other == spelling.substr(0, n);
+                }
+                if (!found) {
+                    return false;
+                }
+            }
+            if (span_operator(spelling) != spelling.size()) {
+                return false;
+            }
+        }
+        return true;
+    }(),
+    "operator_spellings must be prefix-closed"
+);
+
+#endif // OPERATORS_HPP
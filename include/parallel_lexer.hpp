@@ -0,0 +1,65 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PARALLEL_LEXER_HPP
+#define PARALLEL_LEXER_HPP
+
+#include <string_view>
+#include <vector>
+
+#include "ast.hpp"
+
+/**
+ * @brief Lexes a large in-memory input on several threads.
+ *
+ * The input is cut into fixed-size chunks. A chunk may begin inside a
+ * string literal or a comment, so each one is lexed speculatively once per
+ * entry state: plain code, block comment, line comment, and double- and
+ * single-quoted string. The non-code streams stop as soon as they meet the
+ * plain-code stream of the same chunk. A prefix pass then walks the chunks
+ * in file order and takes, for each, a stream with a token starting exactly
+ * where the previous chunk's last token ended; from a token start onwards
+ * lexing is deterministic, so that stream is correct from there. A chunk
+ * no stream fits is lexed again from that offset.
+ *
+ * The result is the token stream reader::next_token() returns for the same
+ * text, eof token included, and malformed input raises the error the
+ * sequential reader would raise first. Symbols are not interned: every
+ * token gets no_symbol.
+ */
+class parallel_lexer {
+public:
+    /// @p threads 0 uses std::thread::hardware_concurrency().
+    explicit parallel_lexer(
+        size_t threads = 0, size_t chunk_size = size_t { 1 } << 20
+    );
+
+    [[nodiscard]] std::vector<token> lex(std::string_view text) const;
+
+private:
+    size_t threads;
+    size_t chunk_size;
+};
+
+#endif // PARALLEL_LEXER_HPP
@@ -25,63 +25,288 @@
 #ifndef READER_HPP
 #define READER_HPP
 
+#include <cstdint>
 #include <filesystem>
-#include <fstream>
+#include <limits>
 #include <source_location>
+#include <vector>
 
 #include "ast.hpp"
+#include "diagnostics.hpp"
+#include "line_index.hpp"
+#include "scan.hpp"
+#include "source.hpp"
+
+/**
+ * @brief How a reader pulls a file into memory.
+ */
+enum class read_mode {
+    buffered, ///< Chunked std::ifstream reads into a fixed-size buffer
+    mapped, ///< Memory-map the whole file and lex straight from the mapping
+    readahead, ///< Buffered, with the next chunk read on a background thread
+    uring ///< Reads queued through io_uring; buffered where unavailable
+};
+
+/**
+ * @brief How a reader keeps track of token positions.
+ */
+enum class position_mode {
+    tracked, ///< Keep line and column up to date while lexing
+    offsets ///< Record byte offsets only; lines come from a line_index
+};
+
+/**
+ * @brief Whether comment tokens carry their text.
+ */
+enum class comment_text {
+    keep, ///< The token holds the whole comment, delimiters included
+    skip ///< Only kind and position are filled; the body is never copied
+};
+
+/**
+ * @brief Byte range of a whitespace run or comment skipped by
+ * reader::next_significant_token.
+ */
+struct trivia_span {
+    token_kind kind; ///< token_kind::whitespace or token_kind::comment
+    std::streamoff file_offset; ///< Offset of the first byte
+    std::streamoff length; ///< Number of bytes, delimiters included
+};
+
+/**
+ * @brief The source a reader opened with @p mode reads @p path through.
+ *
+ * Buffered reads start at @p buffer_size bytes and grow while the file is
+ * read front to back, up to @p max_buffer_size.
+ */
+[[nodiscard]] source_ptr open_source(
+    const std::filesystem::path& path, read_mode mode,
+    std::streamsize buffer_size = 4096,
+    std::streamsize max_buffer_size = default_max_buffer_size
+);
 
 class reader {
 public:
+    /**
+     * @brief Lexer state saved by save() and put back by restore().
+     */
+    struct checkpoint {
+        std::streamoff offset; ///< Offset of the next unread byte
+        int line; ///< Line at that offset
+        int column; ///< Column at that offset
+        std::uint64_t window; ///< Id of the window that held the offset
+    };
+
     explicit reader(
         const std::filesystem::path& path, std::streamsize buffer_size = 4096
     );
 
+    /**
+     * @brief Read @p path the way @p mode says.
+     *
+     * Buffered reads start at @p buffer_size bytes and grow while the file
+     * is read front to back, up to @p max_buffer_size; passing the same
+     * value twice keeps the buffer fixed.
+     */
+    reader(
+        const std::filesystem::path& path, read_mode mode,
+        std::streamsize buffer_size = 4096,
+        std::streamsize max_buffer_size = default_max_buffer_size
+    );
+
     explicit reader(std::string& data) noexcept;
 
-    ~reader();
+    explicit reader(source_ptr input);
+
+    /**
+     * @brief Read @p input, whose bytes were all checked for UTF-8 already.
+     *
+     * @p first_invalid is the offset of the first invalid sequence, as
+     * find_invalid_utf8() gives it for the whole input, or the largest
+     * std::streamoff when there is none. The reader then raises the error
+     * where it would have found it itself, without checking again; this
+     * saves readers that share one input from each checking all of it.
+     */
+    reader(source_ptr input, std::streamoff first_invalid);
 
     void next_token(token& out);
 
+    /**
+     * @brief Read the next token without copying its text where possible.
+     *
+     * With a stable source (in-memory or mapped) the text of every token
+     * except strings with escape sequences is a span of the source bytes,
+     * valid for as long as a keep_alive() handle is held. Decoded strings,
+     * and every token of a buffered file, own their text. With
+     * comment_text::skip comment tokens come back with empty text, which
+     * saves copying long comments for callers that throw them away.
+     */
+    void next_token(
+        token_view& out, comment_text comments = comment_text::keep
+    );
+
+    /**
+     * @brief Read the next token that is neither whitespace nor a comment.
+     *
+     * Trivia is skipped without building tokens for it. When @p trivia is
+     * given, the byte range of every skipped run is appended to it, in the
+     * same order next_token() would have returned them.
+     */
+    void next_significant_token(
+        token_view& out, std::vector<trivia_span>* trivia = nullptr
+    );
+
+    /**
+     * @brief Replace the contents of @p out with up to @p count tokens.
+     *
+     * Only kind, position and raw extent are recorded, no text is copied.
+     * The eof token is the last one stored; a batch that ends with it is
+     * the final one. Returns the number of tokens stored.
+     */
+    size_t next_tokens(token_batch& out, size_t count);
+
+    /// Keeps the bytes token_view spans point into alive; null when the
+    /// source is not stable and every token_view owns its text.
+    [[nodiscard]] std::shared_ptr<const void> keep_alive() const noexcept;
+
+    /**
+     * @brief Switch between tracked lines and columns and offsets only.
+     *
+     * In position_mode::offsets every token gets line and column -1 and
+     * the reader indexes the newlines of each window it loads instead,
+     * with a vectorized count; locate() then answers position queries.
+     * Must be called before the first token is read.
+     */
+    void set_position_mode(position_mode mode);
+
+    /// Line and column of @p offset; position_mode::offsets only.
+    [[nodiscard]] text_position locate(std::streamoff offset) const;
+
+    /// Newline index built in position_mode::offsets.
+    [[nodiscard]] const line_index& lines() const noexcept;
+
     void jump_to_position(std::streamoff position, int line, int column);
 
+    /**
+     * @brief Intern the text of every keyword token into @p table.
+     *
+     * Tokens then carry the id in token::symbol; without a table (the
+     * default, or after passing nullptr) they get no_symbol. The table is
+     * not owned and must outlive the reading.
+     */
+    void intern_symbols(symbol_table* table) noexcept;
+
+    /// Current position, to be passed to restore() later.
+    [[nodiscard]] checkpoint save() const noexcept;
+
+    /**
+     * @brief Continue reading from a position returned by save().
+     *
+     * While the window that was current at save() is still loaded this only
+     * moves the read position, with no I/O; otherwise it falls back to
+     * jump_to_position().
+     */
+    void restore(const checkpoint& point);
+
     void interrupt();
 
 private:
-    std::ifstream ifs;
-    std::string buffer;
-    std::streamsize max_buffer_size {};
+    source_ptr input;
+    std::string_view buffer;
     std::streamoff file_offset {};
     int line { 0 };
     int column { 0 };
     size_t buffer_position { 0 };
+    std::uint64_t window_id { 0 }; ///< Bumped whenever buffer is replaced
+    position_mode positions { position_mode::tracked };
+    line_index newlines;
+    symbol_table* symbols { nullptr };
+    utf8_validator utf8;
+    std::streamoff utf8_checked_from { 0 }; ///< Start of the validated range
+    std::streamoff utf8_checked { 0 }; ///< End of the validated range
+    std::streamoff utf8_error { ///< First invalid byte seen so far
+        std::numeric_limits<std::streamoff>::max()
+    };
+    std::string* capture { nullptr };
+    size_t capture_start { 0 };
+    std::string stitched; ///< Window joined up across a split code point
 
     bool is_valid() const noexcept;
 
-    char peek_char() const noexcept;
+    std::streamoff current_offset() const noexcept;
 
-    unsigned char peek_uchar() const noexcept;
+    char peek_char() const noexcept;
 
     char get_char();
 
     void advance_char();
 
+    void advance_run(size_t length);
+
     void reload_buffer();
 
-    void read_whitespace(std::string& into);
+    /// Join the rest of the window with what follows, up to @p needed bytes.
+    void stitch_window(size_t needed);
+
+    /// Length of the identifier code point at a lead byte the table leaves
+    /// open, or 0.
+    size_t identifier_code_point();
+
+    void index_through(std::streamoff end);
+
+    void check_utf8() noexcept;
+
+    void note_utf8_error(std::streamoff offset) noexcept;
+
+    void throw_on_bad_utf8() const;
+
+    void begin_capture(std::string* into) noexcept;
+
+    void end_capture();
+
+    void advance_lines(std::string_view run);
 
-    void read_keyword(std::string& into);
+    void read_whitespace();
 
-    void read_string(std::string& into);
+    void read_keyword();
 
-    void read_comment(std::string& into);
+    void read_digits();
 
-    token_kind read_number(std::string& into);
+    bool read_string(std::string* into);
+
+    void read_escape(std::string* into);
+
+    void read_comment();
+
+    /// Extend an operator whose bytes so far left the DFA in @p state.
+    void read_operator(std::uint8_t state);
+
+    void skip_trivia(std::vector<trivia_span>* trivia);
+
+    token_kind read_number();
+
+    token_kind
+    read_token(std::string* into, comment_text comments = comment_text::keep);
+
+    token_kind scan_token(std::string* into, comment_text comments);
 
     void init_token(token& t) const noexcept;
 
-    [[nodiscard]] std::runtime_error make_error(
-        const std::string& message,
+    void init_token(token_view& t) const noexcept;
+
+    /// Line and column of @p at, which in position_mode::tracked must lie
+    /// between the start of the window and the read position.
+    [[nodiscard]] text_position position_of(std::streamoff at) const;
+
+    [[nodiscard]] source_excerpt excerpt_at(std::streamoff at) const noexcept;
+
+    [[nodiscard]] diagnostic_error make_error(
+        diagnostic_kind kind,
+        const std::source_location& location = std::source_location::current()
+    ) const;
+
+    [[nodiscard]] diagnostic_error make_error(
+        diagnostic_kind kind, std::streamoff at,
         const std::source_location& location = std::source_location::current()
     ) const;
 };
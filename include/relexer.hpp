@@ -0,0 +1,73 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RELEXER_HPP
+#define RELEXER_HPP
+
+#include <string_view>
+#include <vector>
+
+#include "ast.hpp"
+#include "symbols.hpp"
+
+/**
+ * @brief One replacement of a byte range, in offsets of the old text.
+ */
+struct text_edit {
+    std::streamoff offset; ///< Start of the replaced range
+    std::streamoff removed; ///< Length of the replaced range
+    std::streamoff inserted; ///< Length of the text put in its place
+};
+
+/**
+ * @brief Bring the tokens of a text up to date after @p edits.
+ *
+ * @p previous is the token stream of the old text, eof token included, as
+ * reader::next_token() returns it with tracked positions; @p text is the
+ * old text with @p edits applied. The edits must not overlap and may come
+ * in any order.
+ *
+ * For each edit lexing restarts at the last token that begins before it,
+ * since that token may now run into the edit, or earlier at the first token
+ * that ends less than 4 bytes before it: the reader may look that far past
+ * a token to find where it ends, at a UTF-8 sequence after an identifier.
+ * Lexing goes on, taking in every later edit that begins within 3 bytes of
+ * a re-lexed token's end, until a token begins past the edits taken in at a
+ * place where an old token began too. From a token start the lexer depends on nothing but the bytes ahead,
+ * so every old token from there on to the next edit is reused with its
+ * offset, line and column shifted instead of being lexed again.
+ *
+ * The result is what a reader over @p text returns, with keyword tokens
+ * interned into @p symbols when given; malformed edited text raises the
+ * reader's error. Unchanged tokens are moved out of @p previous. Their
+ * symbol ids are checked against @p symbols by name, so @p previous may
+ * come from another table or none; passing the same table again keeps the
+ * check to one lookup by id per keyword.
+ */
+[[nodiscard]] std::vector<token> relex(
+    std::string_view text, std::vector<token> previous,
+    std::vector<text_edit> edits, symbol_table* symbols = nullptr
+);
+
+#endif // RELEXER_HPP
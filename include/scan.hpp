@@ -0,0 +1,150 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SCAN_HPP
+#define SCAN_HPP
+
+#include <cstddef>
+#include <string_view>
+
+#include "char_class.hpp"
+
+/**
+ * @brief Vectorized run scanners used by the reader hot loops.
+ *
+ * The wide_* kernels compare 32 bytes at a time with AVX2 or 16 with SSE2,
+ * whichever the target enables, and fall back to @ref char_table lookups
+ * for the tail and for other targets. Most runs in ordinary code are a byte
+ * or two long, so the inline wrappers settle the first @ref short_run bytes
+ * themselves and only call into the kernels for long runs.
+ */
+inline constexpr size_t short_run = 16;
+
+size_t wide_span_whitespace(std::string_view text) noexcept;
+
+size_t wide_span_identifier(std::string_view text) noexcept;
+
+size_t wide_span_digits(std::string_view text) noexcept;
+
+size_t wide_span_string_body(std::string_view text, char quote) noexcept;
+
+size_t wide_count_newlines(std::string_view text) noexcept;
+
+size_t wide_span_ascii(std::string_view text) noexcept;
+
+template <bool (*Match)(char), size_t (*Wide)(std::string_view)>
+inline size_t span_run(const std::string_view text) noexcept {
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (!Match(text[i])) {
+            return i;
+        }
+        if (i + 1 == short_run) {
+            return short_run + Wide(text.substr(short_run));
+        }
+    }
+    return text.size();
+}
+
+/// Length of the whitespace run at the start of @p text.
+inline size_t span_whitespace(const std::string_view text) noexcept {
+    return span_run<is_space, wide_span_whitespace>(text);
+}
+
+/// Length of the identifier run ([A-Za-z0-9_]) at the start of @p text.
+inline size_t span_identifier(const std::string_view text) noexcept {
+    return span_run<is_identifier, wide_span_identifier>(text);
+}
+
+/// Length of the digit run at the start of @p text.
+inline size_t span_digits(const std::string_view text) noexcept {
+    return span_run<is_digit, wide_span_digits>(text);
+}
+
+/**
+ * @brief Length of the plain string-literal text at the start of @p text.
+ *
+ * Stops at @p quote, at a backslash and at '\n', so the caller only has to
+ * look at escape sequences and line breaks. @p quote must be '"' or '\''.
+ */
+inline size_t
+span_string_body(const std::string_view text, const char quote) noexcept {
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        if (c == quote || c == '\\' || c == '\n') {
+            return i;
+        }
+        if (i + 1 == short_run) {
+            return short_run
+                + wide_span_string_body(text.substr(short_run), quote);
+        }
+    }
+    return text.size();
+}
+
+/// Number of '\n' bytes in @p text.
+inline size_t count_newlines(const std::string_view text) noexcept {
+    if (text.size() >= short_run) {
+        return wide_count_newlines(text);
+    }
+    size_t count = 0;
+    for (const char c : text) {
+        count += c == '\n';
+    }
+    return count;
+}
+
+/**
+ * @brief Checks UTF-8 window by window, as the reader loads them.
+ *
+ * ASCII runs are skipped with the vectorized wide_span_ascii(), so plain
+ * code costs a few instructions per 32 bytes; only the multi-byte
+ * sequences are decoded, one at a time. A sequence cut by the end of a
+ * window is carried into the next call.
+ */
+class utf8_validator {
+public:
+    /**
+     * @brief Check @p text, which continues whatever was fed before.
+     *
+     * Returns the index within @p text of the first byte of the first
+     * invalid sequence (0 if it began in an earlier window), or npos.
+     * After an error the validator must be reset() before further use.
+     */
+    size_t feed(std::string_view text) noexcept;
+
+    /// Bytes of an unfinished sequence held back from the last feed().
+    [[nodiscard]] size_t pending() const noexcept;
+
+    void reset() noexcept;
+
+private:
+    unsigned char carry[4] {};
+    size_t carried { 0 };
+};
+
+/// Index of the first byte of the first invalid UTF-8 sequence in the whole
+/// of @p text, a sequence cut off by its end included, or npos.
+[[nodiscard]] size_t find_invalid_utf8(std::string_view text) noexcept;
+
+#endif // SCAN_HPP
@@ -0,0 +1,326 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SOURCE_HPP
+#define SOURCE_HPP
+
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * @brief Backend that supplies the reader with raw input bytes.
+ *
+ * The reader never touches files itself: it asks its source for the bytes
+ * starting at a given offset and lexes the returned window until it runs
+ * out, then fetches the window that follows.
+ */
+class source {
+public:
+    virtual ~source();
+
+    /**
+     * @brief Make the bytes starting at @p offset resident.
+     *
+     * The returned window stays valid until the next call to fetch(). An
+     * empty window marks the end of input.
+     */
+    virtual std::string_view fetch(std::streamoff offset) = 0;
+
+    /// Total input size in bytes, or -1 when it is not known up front.
+    [[nodiscard]] virtual std::streamoff size() const noexcept;
+
+    /// True if the input is backed by a file.
+    [[nodiscard]] virtual bool is_open() const noexcept;
+
+    /// True once a file-backed source has delivered its last byte.
+    [[nodiscard]] virtual bool eof() const noexcept;
+
+    /**
+     * @brief True if fetched windows stay valid for the source's lifetime.
+     *
+     * Stable sources never reuse their memory, so views into earlier windows
+     * outlive later fetches. The reader relies on this to hand out token
+     * text as spans instead of copies.
+     */
+    [[nodiscard]] virtual bool stable() const noexcept;
+};
+
+using source_ptr = std::shared_ptr<source>;
+
+/// Largest read a reader lets its file_source grow to by default.
+inline constexpr std::streamsize default_max_buffer_size = 256 << 10;
+
+/**
+ * @brief Reads a file chunk by chunk through std::ifstream.
+ *
+ * Reads start at @p buffer_size bytes. Each fetch that continues where the
+ * previous one ended doubles the next read, up to @p max_buffer_size and
+ * never past the end of the file, so long sequential scans need few calls
+ * into the stream. A fetch anywhere else is taken as random access and
+ * drops back to @p buffer_size. A @p max_buffer_size of 0 keeps the size
+ * fixed.
+ */
+class file_source final : public source {
+public:
+    explicit file_source(
+        const std::filesystem::path& path, std::streamsize buffer_size = 4096,
+        std::streamsize max_buffer_size = 0
+    );
+
+    std::string_view fetch(std::streamoff offset) override;
+
+    [[nodiscard]] std::streamoff size() const noexcept override;
+
+    [[nodiscard]] bool is_open() const noexcept override;
+
+    [[nodiscard]] bool eof() const noexcept override;
+
+private:
+    std::ifstream ifs;
+    std::string buffer;
+    size_t min_chunk;
+    size_t max_chunk;
+    size_t chunk; ///< Bytes the next sequential read asks for
+    std::streamoff file_size {};
+    std::streamoff position {};
+};
+
+/**
+ * @brief Serves an in-memory string as a single window.
+ */
+class memory_source final : public source {
+public:
+    explicit memory_source(std::string data) noexcept;
+
+    std::string_view fetch(std::streamoff offset) override;
+
+    [[nodiscard]] std::streamoff size() const noexcept override;
+
+    [[nodiscard]] bool stable() const noexcept override;
+
+private:
+    std::string data;
+};
+
+/**
+ * @brief Serves bytes owned by the caller as a single window.
+ *
+ * Nothing is copied; the caller keeps @p data alive for as long as the
+ * source and any token text taken from it are in use.
+ */
+class view_source final : public source {
+public:
+    explicit view_source(std::string_view data) noexcept;
+
+    std::string_view fetch(std::streamoff offset) override;
+
+    [[nodiscard]] std::streamoff size() const noexcept override;
+
+    [[nodiscard]] bool stable() const noexcept override;
+
+private:
+    std::string_view data;
+};
+
+/**
+ * @brief Memory-maps a whole file and serves it as a single window.
+ *
+ * Nothing is copied: every window is a view straight into the mapping, so
+ * seeking is pointer arithmetic and the reader never reloads mid-file.
+ */
+class mapped_source final : public source {
+public:
+    explicit mapped_source(const std::filesystem::path& path);
+
+    mapped_source(const mapped_source&) = delete;
+
+    mapped_source& operator=(const mapped_source&) = delete;
+
+    ~mapped_source() override;
+
+    std::string_view fetch(std::streamoff offset) override;
+
+    [[nodiscard]] std::streamoff size() const noexcept override;
+
+    [[nodiscard]] bool is_open() const noexcept override;
+
+    [[nodiscard]] bool eof() const noexcept override;
+
+    [[nodiscard]] bool stable() const noexcept override;
+
+private:
+    std::string_view data;
+#if !defined(__unix__) && !defined(__APPLE__)
+    std::string fallback;
+#endif
+};
+
+/**
+ * @brief Double-buffers another source, fetching the next window on a
+ * background thread while the current one is lexed.
+ *
+ * Every window is copied out of the wrapped source into one of two buffers.
+ * When fetch() hands out one buffer, the worker starts filling the other
+ * with the window that follows it, so sequential reads only wait when the
+ * lexer outruns the I/O. Fetching any other offset (a jump) waits for the
+ * worker and reads synchronously.
+ */
+class readahead_source final : public source {
+public:
+    explicit readahead_source(source_ptr inner);
+
+    readahead_source(const readahead_source&) = delete;
+
+    readahead_source& operator=(const readahead_source&) = delete;
+
+    ~readahead_source() override;
+
+    std::string_view fetch(std::streamoff offset) override;
+
+    [[nodiscard]] std::streamoff size() const noexcept override;
+
+    [[nodiscard]] bool is_open() const noexcept override;
+
+    [[nodiscard]] bool eof() const noexcept override;
+
+private:
+    source_ptr inner;
+    std::streamoff total;
+    bool open;
+    std::string front;
+    std::string back;
+    std::streamoff front_end { 0 };
+    std::streamoff back_offset { -1 }; ///< Offset back holds, -1 if none
+    std::streamoff requested { -1 }; ///< Offset the worker is loading
+    bool exhausted { false };
+    mutable std::mutex mutex;
+    std::condition_variable_any wake;
+    std::condition_variable_any loaded;
+    std::jthread worker; // last: stopped and joined before the rest goes
+
+    void run(std::stop_token stop);
+};
+
+/**
+ * @brief Reads a stream such as a pipe or stdin through a fixed buffer.
+ *
+ * The stream is consumed once, in order, so memory stays bounded by
+ * @p buffer_size whatever the input length. Fetches behind the stream
+ * position (jumps back) throw, unless @p spill is set: then every chunk is
+ * also appended to an anonymous temporary file, which serves them. Jumps
+ * ahead read and discard the bytes in between.
+ */
+class stream_source final : public source {
+public:
+    explicit stream_source(
+        std::istream& in, std::streamsize buffer_size = 4096, bool spill = false
+    );
+
+    stream_source(const stream_source&) = delete;
+
+    stream_source& operator=(const stream_source&) = delete;
+
+    ~stream_source() override;
+
+    std::string_view fetch(std::streamoff offset) override;
+
+    [[nodiscard]] bool is_open() const noexcept override;
+
+    [[nodiscard]] bool eof() const noexcept override;
+
+private:
+    std::istream& in;
+    std::string buffer;
+    std::FILE* spill { nullptr }; ///< Every byte read so far, if enabled
+    std::streamoff streamed { 0 }; ///< Bytes consumed from the stream
+    std::streamoff delivered_end { 0 };
+    bool ended { false };
+
+    size_t pull();
+};
+
+/**
+ * @brief Hit and miss counts of a block_cache_source or a token_cache.
+ */
+struct cache_stats {
+    size_t hits { 0 }; ///< Lookups served from what the cache holds
+    size_t misses { 0 }; ///< Lookups that had to read or lex
+};
+
+/**
+ * @brief Keeps recently read blocks of another source in an LRU cache.
+ *
+ * Blocks are @p block_size bytes at offsets aligned to @p block_size, and
+ * at most @p capacity bytes of them stay resident, though never fewer than
+ * two blocks so the window a reader holds outlives the fetch that follows.
+ * Each fetch() returns the rest of the block holding the offset, so jumping
+ * back to a position near an earlier one (such as re-expanding a
+ * placeholder) reuses a block that is still in memory instead of reading it
+ * again.
+ */
+class block_cache_source final : public source {
+public:
+    explicit block_cache_source(
+        source_ptr inner, size_t capacity = size_t { 1 } << 20,
+        size_t block_size = size_t { 64 } << 10
+    );
+
+    std::string_view fetch(std::streamoff offset) override;
+
+    [[nodiscard]] std::streamoff size() const noexcept override;
+
+    [[nodiscard]] bool is_open() const noexcept override;
+
+    [[nodiscard]] bool eof() const noexcept override;
+
+    [[nodiscard]] cache_stats stats() const noexcept;
+
+private:
+    struct block {
+        std::streamoff offset;
+        std::string data;
+    };
+
+    source_ptr inner;
+    size_t block_size;
+    size_t max_blocks;
+    std::list<block> blocks; ///< Most recently used first
+    std::unordered_map<std::streamoff, std::list<block>::iterator> index;
+    std::streamoff delivered_end { 0 };
+    bool exhausted { false };
+    cache_stats counters;
+
+    void load(block& b);
+};
+
+#endif // SOURCE_HPP
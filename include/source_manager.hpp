@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SOURCE_MANAGER_HPP
+#define SOURCE_MANAGER_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "line_index.hpp"
+#include "reader.hpp"
+#include "source.hpp"
+
+/// Offset into the one address space a source_manager lays its files out in.
+using global_offset = std::uint64_t;
+
+/// Index of a file in a source_manager, in the order files were added.
+using file_id = std::uint32_t;
+
+/**
+ * @brief Where a global_offset points.
+ */
+struct global_position {
+    file_id file; ///< File holding the offset
+    std::streamoff offset; ///< Offset within that file
+    text_position position; ///< Zero-based line and column in that file
+};
+
+/**
+ * @brief Holds many inputs and places them in a single 64-bit offset space.
+ *
+ * Every file gets the range [base, base + size], its eof position
+ * included, and the next file starts one past it, so a token position is
+ * one integer that names both file and offset: to_global() turns a
+ * token's file_offset into one and locate() turns it back into file, line
+ * and column. Sizes must be known when a file is added.
+ *
+ * Files added by path are opened with open_source(). Memory-mapped ones
+ * share one mapping; other modes get a fresh source on every open(), since
+ * a buffered source only keeps one window. Adding a path that is already
+ * held returns its existing id. Sources added as they are, cached or
+ * in-memory ones among them, are shared by every open().
+ *
+ * locate() counts the lines of a file the first time it is asked about
+ * it, by reading the file through open(). For a shared source that is not
+ * stable, that must not happen while a reader is using it. The manager is
+ * not safe to use from several threads at once.
+ */
+class source_manager {
+public:
+    file_id add_file(
+        const std::filesystem::path& path, read_mode mode = read_mode::mapped
+    );
+
+    file_id add_source(std::string name, source_ptr input);
+
+    file_id add_buffer(std::string name, std::string text);
+
+    [[nodiscard]] size_t file_count() const noexcept;
+
+    /// Path of a file added by path, otherwise the name it was given.
+    [[nodiscard]] const std::string& name(file_id file) const;
+
+    [[nodiscard]] std::streamoff size(file_id file) const;
+
+    /// First global offset of @p file.
+    [[nodiscard]] global_offset base(file_id file) const;
+
+    [[nodiscard]] global_offset
+    to_global(file_id file, std::streamoff offset) const;
+
+    [[nodiscard]] file_id file_of(global_offset at) const;
+
+    [[nodiscard]] global_position locate(global_offset at) const;
+
+    /// A source to read @p file through, e.g. with reader(source_ptr).
+    [[nodiscard]] source_ptr open(file_id file) const;
+
+private:
+    struct file_entry {
+        std::string name;
+        std::filesystem::path path; ///< Empty for added sources
+        read_mode mode { read_mode::mapped };
+        source_ptr input; ///< Shared source, null when opened per use
+        global_offset base { 0 };
+        std::streamoff size { 0 };
+        mutable line_index lines;
+        mutable bool indexed { false };
+    };
+
+    std::vector<file_entry> files;
+    std::vector<global_offset> bases; ///< Base of every file, for file_of()
+    std::unordered_map<std::string, file_id> by_path;
+    global_offset next_base { 0 };
+
+    file_id add(file_entry entry);
+
+    const file_entry& entry(file_id file) const;
+};
+
+#endif // SOURCE_MANAGER_HPP
@@ -0,0 +1,134 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SYMBOLS_HPP
+#define SYMBOLS_HPP
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Sub-kind of a token_kind::keyword token: a plain identifier or one
+ * of the reserved words.
+ */
+enum class keyword_kind : std::uint8_t {
+    identifier, ///< Not a reserved word
+    if_kw,
+    elif_kw,
+    else_kw,
+    while_kw,
+    for_kw,
+    try_kw,
+    catch_kw,
+    finally_kw,
+    return_kw,
+    break_kw,
+    continue_kw,
+    goto_kw
+};
+
+/// Spelling of every reserved word, in keyword_kind order from if_kw.
+inline constexpr std::array<std::string_view, 12> reserved_words {
+    "if",  "elif",  "else",    "while",  "for",   "try",
+    "catch", "finally", "return", "break", "continue", "goto"
+};
+
+/// Perfect hash of the reserved words into 16 slots, from the length and
+/// the first and last bytes. Other words may collide; the caller compares.
+constexpr size_t reserved_hash(const std::string_view word) noexcept {
+    return (word.size() * 6 + static_cast<unsigned char>(word.front()) * 2U
+            + static_cast<unsigned char>(word.back()))
+        & 15U;
+}
+
+/// Slot -> keyword_kind, identifier for the empty slots.
+inline constexpr auto reserved_slots = [] {
+    std::array<keyword_kind, 16> slots {};
+    for (size_t i = 0; i < reserved_words.size(); ++i) {
+        slots[reserved_hash(reserved_words[i])]
+            = static_cast<keyword_kind>(i + 1);
+    }
+    return slots;
+}();
+
+static_assert(
+    [] {
+        for (size_t i = 0; i < reserved_words.size(); ++i) {
+            const auto slot = reserved_slots[reserved_hash(reserved_words[i])];
+            if (slot != static_cast<keyword_kind>(i + 1)) {
+                return false;
+            }
+        }
+        return true;
+    }(),
+    "reserved_hash must not collide on reserved words"
+);
+
+/// Sub-kind of the identifier @p word: one hash, one compare.
+constexpr keyword_kind classify_keyword(const std::string_view word) noexcept {
+    if (word.size() < 2 || word.size() > 8) {
+        return keyword_kind::identifier;
+    }
+    const auto kind = reserved_slots[reserved_hash(word)];
+    if (kind == keyword_kind::identifier
+        || reserved_words[static_cast<size_t>(kind) - 1] != word) {
+        return keyword_kind::identifier;
+    }
+    return kind;
+}
+
+/// Symbol id of tokens that were not interned.
+inline constexpr std::uint32_t no_symbol = UINT32_MAX;
+
+/**
+ * @brief Maps identifiers to dense 32-bit ids, so later passes compare
+ * symbols as integers.
+ *
+ * The reserved words are interned first: the id of reserved word @c k is
+ * <tt>static_cast<std::uint32_t>(k) - 1</tt>. Names are stored once and
+ * stay valid for the table's lifetime.
+ */
+class symbol_table {
+public:
+    symbol_table();
+
+    /// Id of @p name, adding it if it is new.
+    std::uint32_t intern(std::string_view name);
+
+    /// Name of @p id; throws std::out_of_range for unknown ids.
+    [[nodiscard]] std::string_view name(std::uint32_t id) const;
+
+    /// Number of distinct names interned, reserved words included.
+    [[nodiscard]] size_t size() const noexcept;
+
+private:
+    std::deque<std::string> names; ///< Indexed by id; never reallocated
+    std::unordered_map<std::string_view, std::uint32_t> ids;
+};
+
+#endif // SYMBOLS_HPP
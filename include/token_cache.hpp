@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TOKEN_CACHE_HPP
+#define TOKEN_CACHE_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include "ast.hpp"
+#include "source.hpp"
+
+/// Default size limit of a token_cache directory: 256 MiB.
+inline constexpr std::uintmax_t default_token_cache_capacity = 256 << 20;
+
+/**
+ * @brief Token stream of one text, as stored in a token_cache entry.
+ *
+ * The entry is a compact binary image: the offset, kind and reserved-word
+ * kind of every token, eof included, and the decoded value of every
+ * numeric literal. Lengths follow from consecutive offsets, since tokens
+ * tile the text. Entries read from disk are memory-mapped and decoded on
+ * access. Text is sliced from the source the stream was looked up with,
+ * which must outlive it.
+ */
+class cached_tokens {
+public:
+    [[nodiscard]] size_t size() const noexcept;
+
+    [[nodiscard]] token_kind kind(size_t index) const;
+
+    [[nodiscard]] keyword_kind keyword(size_t index) const;
+
+    [[nodiscard]] std::streamoff offset(size_t index) const;
+
+    /// Raw byte extent, quotes and escape sequences included.
+    [[nodiscard]] std::streamoff length(size_t index) const;
+
+    [[nodiscard]] std::string_view text(size_t index) const;
+
+    /// Decoded literal of integer and floating tokens, empty otherwise.
+    [[nodiscard]] number_value value(size_t index) const;
+
+private:
+    friend class token_cache;
+
+    cached_tokens(
+        std::shared_ptr<const void> storage, std::string_view image,
+        std::string_view source
+    );
+
+    std::shared_ptr<const void> storage; ///< Keeps image alive
+    std::string_view image;
+    std::string_view source;
+    size_t count { 0 };
+    size_t literals { 0 };
+};
+
+/**
+ * @brief On-disk cache of token streams, addressed by source content.
+ *
+ * Each entry is a file in @p directory named after a 64-bit hash and the
+ * length of the text it was lexed from, so unchanged files hit whatever
+ * their path. New entries are written to a temporary file and renamed into
+ * place, which makes concurrent runs over one directory safe. When the
+ * entries outgrow @p capacity bytes the least recently used ones are
+ * deleted; a hit counts as a use. Their total size is read from the
+ * directory when the cache is made and then tracked as entries are written,
+ * so the directory is only walked again once that total crosses the
+ * capacity. Entries that fail validation are lexed again and replaced. A
+ * cache that cannot be written to still lexes, it just keeps nothing.
+ */
+class token_cache {
+public:
+    explicit token_cache(
+        std::filesystem::path directory,
+        std::uintmax_t capacity = default_token_cache_capacity
+    );
+
+    /**
+     * @brief Tokens of @p text, mapped from an entry or lexed and stored.
+     *
+     * Lexing errors propagate as reader errors, and nothing is stored.
+     */
+    [[nodiscard]] cached_tokens tokens_of(std::string_view text);
+
+    /// Delete least recently used entries until they fit the capacity.
+    void trim();
+
+    [[nodiscard]] cache_stats stats() const noexcept;
+
+private:
+    [[nodiscard]] std::filesystem::path entry_path(std::string_view text
+    ) const;
+
+    std::filesystem::path directory;
+    std::uintmax_t capacity;
+    std::uintmax_t used { 0 }; ///< Entry bytes at the last trim, plus writes
+    cache_stats counters;
+};
+
+#endif // TOKEN_CACHE_HPP
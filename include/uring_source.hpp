@@ -0,0 +1,164 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef URING_SOURCE_HPP
+#define URING_SOURCE_HPP
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "source.hpp"
+
+/**
+ * @brief Minimal Linux io_uring instance for file reads, driven through
+ * raw system calls.
+ *
+ * Reads are queued with read() and reach the kernel in one batch at the
+ * next submit() or wait(). Several sources can share a ring, which is how
+ * the reads of a whole batch of files get queued together. A ring is not
+ * thread-safe; use it from one thread.
+ */
+class io_ring {
+public:
+    /// A ring with room for @p entries queued reads, or null when
+    /// io_uring is not available on this system.
+    static std::shared_ptr<io_ring> create(unsigned entries = 64);
+
+    io_ring(const io_ring&) = delete;
+
+    io_ring& operator=(const io_ring&) = delete;
+
+    ~io_ring();
+
+    /// Queue a read of @p length bytes at @p offset of @p fd into @p into;
+    /// returns the ticket to wait() on.
+    std::uint64_t
+    read(int fd, char* into, size_t length, std::streamoff offset);
+
+    /// Hand all queued reads to the kernel without waiting.
+    void submit();
+
+    /// Block until the read @p ticket is done; bytes read or -errno.
+    std::int64_t wait(std::uint64_t ticket);
+
+private:
+    io_ring() = default;
+
+    int ring_fd { -1 };
+    unsigned entries { 0 };
+    unsigned queued { 0 };
+    std::uint64_t next_ticket { 1 };
+    std::unordered_map<std::uint64_t, std::int64_t> finished;
+
+    void* sq_map { nullptr };
+    size_t sq_map_size { 0 };
+    void* cq_map { nullptr };
+    size_t cq_map_size { 0 };
+    void* sqe_map { nullptr };
+    size_t sqe_map_size { 0 };
+
+    unsigned* sq_head { nullptr };
+    unsigned* sq_tail { nullptr };
+    unsigned* sq_mask { nullptr };
+    unsigned* sq_array { nullptr };
+    unsigned* cq_head { nullptr };
+    unsigned* cq_tail { nullptr };
+    unsigned* cq_mask { nullptr };
+    void* cqes { nullptr };
+
+    void enter(unsigned submit, unsigned wait_for);
+
+    void reap();
+};
+
+/**
+ * @brief Reads a file through an io_ring, one window ahead.
+ *
+ * The first window is queued on construction, and each fetch() queues the
+ * window after the one it returns, so the kernel reads while the lexer
+ * works. Failed or short ring reads are completed with pread().
+ */
+class uring_source final : public source {
+public:
+    uring_source(
+        const std::filesystem::path& path, std::shared_ptr<io_ring> ring,
+        std::streamsize buffer_size = 4096
+    );
+
+    uring_source(const uring_source&) = delete;
+
+    uring_source& operator=(const uring_source&) = delete;
+
+    ~uring_source() override;
+
+    std::string_view fetch(std::streamoff offset) override;
+
+    [[nodiscard]] std::streamoff size() const noexcept override;
+
+    [[nodiscard]] bool is_open() const noexcept override;
+
+    [[nodiscard]] bool eof() const noexcept override;
+
+private:
+    struct slot {
+        std::string buffer;
+        std::streamoff offset { -1 }; ///< File offset buffer is for
+        std::uint64_t ticket { 0 }; ///< Read in flight, 0 if none
+        size_t length { 0 }; ///< Bytes valid once the read is done
+    };
+
+    std::shared_ptr<io_ring> ring;
+    int fd { -1 };
+    std::streamoff file_size { 0 };
+    std::streamoff delivered_end { 0 };
+    bool exhausted { false };
+    std::array<slot, 2> slots;
+    size_t current { 0 };
+
+    void queue(slot& s, std::streamoff offset);
+
+    void complete(slot& s);
+};
+
+/// A uring_source on @p ring, or a file_source when @p ring is null.
+source_ptr make_uring_source(
+    const std::filesystem::path& path, std::shared_ptr<io_ring> ring,
+    std::streamsize buffer_size = 4096
+);
+
+/**
+ * @brief Open every file of a batch on one shared ring.
+ *
+ * The first window of each file is queued and submitted before this
+ * returns, so the kernel fetches them all while the first file is lexed.
+ * Falls back to file_source when io_uring is not available.
+ */
+std::vector<source_ptr> open_uring_batch(
+    const std::vector<std::filesystem::path>& paths,
+    std::streamsize buffer_size = 4096
+);
+
+#endif // URING_SOURCE_HPP
@@ -24,6 +24,8 @@
 
 #include "ast.hpp"
 
+#include "line_index.hpp"
+
 token::~token() = default;
 
 static const char* token_kind_name(const token_kind k) noexcept {
@@ -34,15 +36,134 @@ static const char* token_kind_name(const token_kind k) noexcept {
     return names[static_cast<size_t>(k)];
 }
 
+static void dump_token(
+    std::ostream& os, const std::string& prefix, const bool is_last,
+    const token_kind kind, const int line, const int column,
+    const std::string_view word
+) noexcept {
+    os << prefix << (is_last ? "`-" : "|-") << "Token(" << token_kind_name(kind)
+       << ") <" << line << ":" << column << ">(\"" << word << "\")\n";
+}
+
 void token::dump(
     std::ostream& os, const std::string& prefix, const bool is_last
 ) const noexcept {
-    os << prefix << (is_last ? "`-" : "|-") << "Token(" << token_kind_name(kind)
-       << ") <" << line << ":" << column << ">(\"" << word << "\")\n";
+    dump_token(os, prefix, is_last, kind, line, column, word);
 }
 
 void token::dump(std::ostream& os) const noexcept { dump(os, "", true); }
 
+void token::dump(std::ostream& os, const line_index& lines) const noexcept {
+    const auto at = lines.locate(file_offset);
+    dump_token(os, "", true, kind, at.line, at.column, word);
+}
+
+token_view::token_view(const token_view& other)
+    : kind(other.kind)
+    , line(other.line)
+    , column(other.column)
+    , file_offset(other.file_offset)
+    , word(other.word)
+    , storage(other.storage)
+    , value(other.value)
+    , keyword(other.keyword)
+    , symbol(other.symbol) {
+    if (other.owns()) {
+        word = storage;
+    }
+}
+
+token_view::token_view(token_view&& other) noexcept
+    : kind(other.kind)
+    , line(other.line)
+    , column(other.column)
+    , file_offset(other.file_offset)
+    , word(other.word)
+    , value(std::move(other.value))
+    , keyword(other.keyword)
+    , symbol(other.symbol) {
+    const bool owned = other.owns();
+    storage = std::move(other.storage);
+    if (owned) {
+        word = storage;
+    }
+}
+
+token_view& token_view::operator=(const token_view& other) {
+    if (this != &other) {
+        *this = token_view(other);
+    }
+    return *this;
+}
+
+token_view& token_view::operator=(token_view&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    const bool owned = other.owns();
+    kind = other.kind;
+    line = other.line;
+    column = other.column;
+    file_offset = other.file_offset;
+    word = other.word;
+    storage = std::move(other.storage);
+    value = std::move(other.value);
+    keyword = other.keyword;
+    symbol = other.symbol;
+    if (owned) {
+        word = storage;
+    }
+    return *this;
+}
+
+token_view::~token_view() = default;
+
+bool token_view::owns() const noexcept {
+    return word.data() == storage.data();
+}
+
+void token_view::dump(
+    std::ostream& os, const std::string& prefix, const bool is_last
+) const noexcept {
+    dump_token(os, prefix, is_last, kind, line, column, word);
+}
+
+void token_view::dump(std::ostream& os) const noexcept { dump(os, "", true); }
+
+void token_view::dump(std::ostream& os, const line_index& lines)
+    const noexcept {
+    const auto at = lines.locate(file_offset);
+    dump_token(os, "", true, kind, at.line, at.column, word);
+}
+
+size_t token_batch::size() const noexcept { return kinds.size(); }
+
+bool token_batch::empty() const noexcept { return kinds.empty(); }
+
+void token_batch::clear() noexcept {
+    kinds.clear();
+    offsets.clear();
+    lengths.clear();
+    lines.clear();
+    columns.clear();
+}
+
+void token_batch::resize(const size_t count) {
+    kinds.resize(count);
+    offsets.resize(count);
+    lengths.resize(count);
+    lines.resize(count);
+    columns.resize(count);
+}
+
+std::string_view
+token_batch::text(const size_t index, const std::string_view source) const {
+    return source.substr(
+        static_cast<size_t>(offsets.at(index)),
+        static_cast<size_t>(lengths.at(index))
+    );
+}
+
 ast_node::~ast_node() = default;
 
 ast_node const* ast_node::first() const noexcept { return this; }
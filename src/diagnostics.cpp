@@ -0,0 +1,122 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "diagnostics.hpp"
+
+#include <mutex>
+#include <sstream>
+
+std::string_view describe(const diagnostic_kind kind) noexcept {
+    static constexpr std::string_view descriptions[]
+        = { "missing closing comment delimiter",
+            "missing closing quote",
+            "invalid Unicode escape",
+            "invalid escape sequence",
+            "leading zeros not allowed",
+            "expected digit",
+            "digit expected after decimal",
+            "digit expected after exponent",
+            "invalid UTF-8",
+            "position is out of range",
+            "interrupted" };
+    return descriptions[static_cast<size_t>(kind)];
+}
+
+std::string_view source_excerpt::text() const noexcept {
+    return { bytes.data(), length };
+}
+
+void diagnostic::render(std::ostream& os) const {
+    if (position.line >= 0) {
+        os << "line " << (position.line + 1) << ", column "
+           << (position.column + 1) << ' ';
+    }
+    os << "(offset " << offset << "): " << describe(kind);
+    if (excerpt.length > 0) {
+        // tabs stay tabs so that the caret lines up under them
+        std::string marker(excerpt.caret, ' ');
+        for (size_t i = 0; i < excerpt.caret; ++i) {
+            if (excerpt.bytes[i] == '\t') {
+                marker[i] = '\t';
+            }
+        }
+        os << "\n    " << excerpt.text() << "\n    " << marker << '^';
+    }
+#ifndef NDEBUG
+    os << "\nin file: " << origin.file_name() << '(' << origin.line() << ':'
+       << origin.column() << ") `" << origin.function_name() << "`";
+#endif
+}
+
+/// Text of a diagnostic_error, rendered once however many threads ask.
+struct diagnostic_error::rendering {
+    std::once_flag once;
+    std::string text; ///< Empty if rendering failed
+};
+
+diagnostic_error::diagnostic_error(const diagnostic& info)
+    // descriptions are literals, so data() is null-terminated
+    : std::runtime_error(describe(info.kind).data())
+    , details(info)
+    , rendered(std::make_shared<rendering>()) { }
+
+const char* diagnostic_error::what() const noexcept {
+    try {
+        std::call_once(rendered->once, [this] {
+            try {
+                std::ostringstream oss;
+                oss << "[Reader-Error] ";
+                details.render(oss);
+                rendered->text = oss.str();
+            } catch (...) {
+                // settle on the plain description for every caller
+            }
+        });
+    } catch (...) {
+        return std::runtime_error::what();
+    }
+    return rendered->text.empty() ? std::runtime_error::what()
+                                  : rendered->text.c_str();
+}
+
+const diagnostic& diagnostic_error::info() const noexcept { return details; }
+
+void diagnostic_batch::add(const diagnostic& item) { list.push_back(item); }
+
+bool diagnostic_batch::empty() const noexcept { return list.empty(); }
+
+size_t diagnostic_batch::size() const noexcept { return list.size(); }
+
+const std::vector<diagnostic>& diagnostic_batch::items() const noexcept {
+    return list;
+}
+
+void diagnostic_batch::render(std::ostream& os) const {
+    for (const auto& item : list) {
+        item.render(os);
+        os << '\n';
+    }
+}
+
+void diagnostic_batch::clear() noexcept { list.clear(); }
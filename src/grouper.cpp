@@ -33,12 +33,11 @@ grouper::grouper(reader& r, const size_t limit)
 }
 
 group_ptr grouper::parse_group(const group_kind kind) {
-    auto group = std::make_shared<group_node>();
-    group->limit = limit;
-    auto top = std::make_shared<group_node>();
-    top->limit = limit;
+    auto group = make_group();
+    auto top = make_group();
+    token_view current;
     while (true) {
-        const token current = peek();
+        peek(current);
         if (current.kind == token_kind::separator) {
             if (current.word == ":") {
                 top->kind = group_kind::key;
@@ -48,7 +47,7 @@ group_ptr grouper::parse_group(const group_kind kind) {
                 top->kind = group_kind::command;
             } else {
                 throw make_error(
-                    "unexpected separator: " + current.word
+                    "unexpected separator: " + std::string(current.word)
                 ); // todo: top->dump()
             }
             if (top->kind == kind) {
@@ -67,8 +66,7 @@ group_ptr grouper::parse_group(const group_kind kind) {
             } catch (const std::runtime_error&) {
                 throw make_error("group limit exceeded");
             }
-            top = std::make_shared<group_node>();
-            top->limit = limit;
+            top = make_group();
         } else if (current.kind == token_kind::open_bracket) {
             group_kind sub_kind;
             if (current.word == "{") {
@@ -79,7 +77,7 @@ group_ptr grouper::parse_group(const group_kind kind) {
                 sub_kind = group_kind::paren;
             } else {
                 throw make_error(
-                    "unexpected open bracket: " + current.word
+                    "unexpected open bracket: " + std::string(current.word)
                 ); // todo: top->dump()
             }
             try {
@@ -94,8 +92,7 @@ group_ptr grouper::parse_group(const group_kind kind) {
             } catch (const std::runtime_error&) {
                 throw make_error("group limit exceeded");
             }
-            top = std::make_shared<group_node>();
-            top->limit = limit;
+            top = make_group();
             if (current.kind == token_kind::eof) {
                 group->kind = group_kind::file;
             } else if (current.word == "}") {
@@ -106,7 +103,7 @@ group_ptr grouper::parse_group(const group_kind kind) {
                 group->kind = group_kind::paren;
             } else {
                 throw make_error(
-                    "unexpected close bracket: " + current.word
+                    "unexpected close bracket: " + std::string(current.word)
                 ); // todo: group->dump()
             }
             if (group->kind == kind) {
@@ -115,7 +112,7 @@ group_ptr grouper::parse_group(const group_kind kind) {
             throw make_error("wrong group kind");
         } else {
             auto tk = std::make_shared<token_node>();
-            tk->value = current;
+            tk->value = std::move(current);
             try {
                 top->append(tk);
             } catch (const std::runtime_error&) {
@@ -125,13 +122,15 @@ group_ptr grouper::parse_group(const group_kind kind) {
     }
 }
 
-token grouper::peek() const {
-    token current;
-    do {
-        src.next_token(current);
-    } while (current.kind == token_kind::whitespace
-             || current.kind == token_kind::comment);
-    return current;
+group_ptr grouper::make_group() const {
+    auto group = std::make_shared<group_node>();
+    group->limit = limit;
+    group->keep_alive = src.keep_alive();
+    return group;
+}
+
+void grouper::peek(token_view& current) const {
+    src.next_significant_token(current);
 }
 
 std::runtime_error grouper::make_error(
@@ -0,0 +1,76 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "line_index.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "scan.hpp"
+
+void line_index::add(std::string_view text, const std::streamoff offset) {
+    if (offset < 0 || offset > end) {
+        throw std::invalid_argument("line_index: text leaves a gap");
+    }
+    const auto known = static_cast<size_t>(end - offset);
+    if (known >= text.size()) {
+        return;
+    }
+    text.remove_prefix(known);
+    const auto needed = line_starts.size() + count_newlines(text);
+    if (needed > line_starts.capacity()) {
+        line_starts.reserve(std::max(needed, 2 * line_starts.capacity()));
+    }
+    const char* const begin = text.data();
+    const char* const last = begin + text.size();
+    const char* p = begin;
+    while (true) {
+        p = static_cast<const char*>(
+            std::memchr(p, '\n', static_cast<size_t>(last - p))
+        );
+        if (!p) {
+            break;
+        }
+        ++p;
+        line_starts.push_back(end + (p - begin));
+    }
+    end += static_cast<std::streamoff>(text.size());
+}
+
+std::streamoff line_index::indexed_end() const noexcept { return end; }
+
+size_t line_index::line_count() const noexcept { return line_starts.size(); }
+
+text_position line_index::locate(const std::streamoff offset) const {
+    if (offset < 0) {
+        throw std::out_of_range("line_index: negative offset");
+    }
+    // the last line start at or before offset
+    const auto next
+        = std::upper_bound(line_starts.begin(), line_starts.end(), offset);
+    const auto line = next - line_starts.begin() - 1;
+    const auto start = line_starts[static_cast<size_t>(line)];
+    return { static_cast<int>(line), static_cast<int>(offset - start) };
+}
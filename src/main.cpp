@@ -23,36 +23,84 @@
  */
 
 #include <cxxopts.hpp>
+#include <fstream>
 #include <iostream>
 
 #include "reader.hpp"
+#include "token_cache.hpp"
 
 int main(const int argc, char* argv[]) {
     std::filesystem::path path;
+    std::filesystem::path cache_directory;
+    std::uintmax_t cache_size = default_token_cache_capacity >> 20;
     try {
         cxxopts::Options options(
             "QuasiPiler", "the Hunchback Dragon of Compilers"
         );
         options
-            .add_options()("i,input", "Input file", cxxopts::value<std::filesystem::path>(path))(
-                "h,help", "show help"
-            );
+            .add_options()("i,input", "Input file, a pipe, or - for stdin", cxxopts::value<std::filesystem::path>(path))(
+                "cache-dir",
+                "Keep the tokens of input files in this directory and reuse "
+                "them while the file content is unchanged",
+                cxxopts::value<std::filesystem::path>(cache_directory)
+            )(
+                "cache-size", "Size limit of the token cache in MiB (256)",
+                cxxopts::value<std::uintmax_t>(cache_size)
+            )("h,help", "show help");
         options.parse_positional({ "input" });
         if (const auto result = options.parse(argc, argv);
             result.count("help")) {
             std::cout << options.help() << "\n";
             return 0;
         }
-        if (path.empty() || !exists(path) || !is_regular_file(path)) {
+        if (path.empty() || (path != "-" && !exists(path))) {
             std::cerr << "input file is required.\n";
             return 1;
         }
+        if (path != "-" && !is_regular_file(path) && !is_fifo(path)) {
+            std::cerr << "input must be a regular file, a pipe or -: "
+                      << path.string() << "\n";
+            return 1;
+        }
     } catch (const cxxopts::exceptions::exception& e) {
         std::cerr << "error parsing options: " << e.what() << "\n";
         return 1;
     }
 
-    reader r(path);
+    if (path != "-" && is_regular_file(path)) {
+        if (cache_directory.empty()) {
+            reader r(path);
+            return 0;
+        }
+        diagnostic_batch errors;
+        try {
+            const auto input = std::make_shared<mapped_source>(path);
+            token_cache cache(cache_directory, cache_size << 20);
+            errors.collect([&] { (void)cache.tokens_of(input->fetch(0)); });
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+        for (const auto& error : errors.items()) {
+            std::cerr << path.string() << ": ";
+            error.render(std::cerr);
+            std::cerr << "\n";
+        }
+        return errors.empty() ? 0 : 1;
+    }
+    // stdin or a pipe: stream it instead of slurping it into memory, which
+    // also leaves it uncached, as hashing it would need all of it first
+    std::ifstream pipe;
+    if (path != "-") {
+        pipe.open(path, std::ios::in | std::ios::binary);
+        if (!pipe.is_open()) {
+            std::cerr << "cannot open input: " << path.string() << "\n";
+            return 1;
+        }
+    }
+    std::istream& in = path == "-" ? std::cin : pipe;
+    // read once, front to back: nothing jumps back, so nothing is spilled
+    reader r(std::make_shared<stream_source>(in, 4096, false));
 
     return 0;
 }
\ No newline at end of file
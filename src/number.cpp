@@ -0,0 +1,166 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "number.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+
+/// Multiply @p limbs by @p factor and add @p addend, in place.
+static void multiply_add(
+    std::vector<std::uint32_t>& limbs, const std::uint32_t factor,
+    std::uint32_t addend
+) {
+    std::uint64_t carry = addend;
+    for (auto& limb : limbs) {
+        const auto product = std::uint64_t { limb } * factor + carry;
+        limb = static_cast<std::uint32_t>(product);
+        carry = product >> 32;
+    }
+    if (carry != 0) {
+        limbs.push_back(static_cast<std::uint32_t>(carry));
+    }
+}
+
+/// Divide @p limbs by @p divisor in place and return the remainder.
+static std::uint32_t
+divide(std::vector<std::uint32_t>& limbs, const std::uint32_t divisor) {
+    std::uint64_t remainder = 0;
+    for (auto it = limbs.rbegin(); it != limbs.rend(); ++it) {
+        const auto current = (remainder << 32) | *it;
+        *it = static_cast<std::uint32_t>(current / divisor);
+        remainder = current % divisor;
+    }
+    while (!limbs.empty() && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+    return static_cast<std::uint32_t>(remainder);
+}
+
+big_number big_number::parse(const std::string_view literal) {
+    const auto mantissa_end
+        = std::min(literal.find_first_of("eE"), literal.size());
+    const auto mantissa = literal.substr(0, mantissa_end);
+    const auto point = mantissa.find('.');
+
+    big_number result;
+    if (mantissa_end < literal.size()) {
+        // saturate absurd exponents instead of overflowing
+        constexpr std::int64_t limit
+            = std::numeric_limits<std::int64_t>::max() / 20;
+        auto digits = literal.substr(mantissa_end + 1);
+        const bool negative = !digits.empty() && digits.front() == '-';
+        if (!digits.empty()
+            && (digits.front() == '-' || digits.front() == '+')) {
+            digits.remove_prefix(1);
+        }
+        for (const char c : digits) {
+            result.exponent
+                = std::min(result.exponent * 10 + (c - '0'), limit);
+        }
+        if (negative) {
+            result.exponent = -result.exponent;
+        }
+    }
+    if (point != std::string_view::npos) {
+        result.exponent
+            -= static_cast<std::int64_t>(mantissa.size() - point - 1);
+    }
+
+    // the digits without the point, leading and trailing zeros
+    std::string digits;
+    digits.reserve(mantissa.size());
+    for (const char c : mantissa) {
+        if (c != '.' && (c != '0' || !digits.empty())) {
+            digits += c;
+        }
+    }
+    const auto last = digits.find_last_not_of('0');
+    if (last == std::string::npos) {
+        result.exponent = 0;
+        return result;
+    }
+    result.exponent += static_cast<std::int64_t>(digits.size() - last - 1);
+    digits.resize(last + 1);
+
+    // nine decimal digits at a time fit a limb
+    result.limbs.reserve(digits.size() / 9 + 1);
+    size_t at = 0;
+    size_t take = digits.size() % 9 == 0 ? 9 : digits.size() % 9;
+    while (at < digits.size()) {
+        std::uint32_t chunk = 0;
+        std::uint32_t scale = 1;
+        for (size_t i = 0; i < take; ++i) {
+            chunk = chunk * 10
+                + static_cast<std::uint32_t>(digits[at + i] - '0');
+            scale *= 10;
+        }
+        multiply_add(result.limbs, scale, chunk);
+        at += take;
+        take = 9;
+    }
+    return result;
+}
+
+std::string big_number::to_string() const {
+    if (limbs.empty()) {
+        return "0";
+    }
+    auto rest = limbs;
+    std::string reversed;
+    while (!rest.empty()) {
+        auto chunk = divide(rest, 1000000000);
+        for (int i = 0; i < 9 && (chunk != 0 || !rest.empty()); ++i) {
+            reversed += static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+    std::string text(reversed.rbegin(), reversed.rend());
+    if (exponent != 0) {
+        text += 'e';
+        text += std::to_string(exponent);
+    }
+    return text;
+}
+
+number_value
+decode_number(const std::string_view literal, const bool floating) {
+    const auto* const first = literal.data();
+    const auto* const last = first + literal.size();
+    if (floating) {
+        double value {};
+        const auto [end, error] = std::from_chars(first, last, value);
+        if (error == std::errc {} && end == last) {
+            return value;
+        }
+    } else {
+        std::int64_t value {};
+        const auto [end, error] = std::from_chars(first, last, value);
+        if (error == std::errc {} && end == last) {
+            return value;
+        }
+    }
+    return std::make_shared<const big_number>(big_number::parse(literal));
+}
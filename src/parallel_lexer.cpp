@@ -0,0 +1,434 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "parallel_lexer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "line_index.hpp"
+#include "reader.hpp"
+#include "scan.hpp"
+
+enum class entry_state {
+    code,
+    block_comment,
+    line_comment,
+    double_quoted,
+    single_quoted
+};
+
+inline constexpr size_t entry_state_count = 5;
+
+/// Tokens lexed from one entry state of one chunk.
+struct lex_stream {
+    token_batch tokens; ///< Tokens starting before the chunk end
+    std::streamoff exit { -1 }; ///< Start of the first token past the chunk
+    std::streamoff failed_at { -1 }; ///< Token start where lexing threw
+    size_t merge { static_cast<size_t>(-1) }; ///< Code stream index joined
+};
+
+/// A run of chosen tokens, in file order.
+struct lex_piece {
+    const token_batch* tokens;
+    size_t from;
+    size_t to;
+};
+
+/// Runs job(0) .. job(jobs - 1) on up to @p threads threads, this one
+/// included, and rethrows the first exception once all of them are done.
+template <typename Job>
+static void run_parallel(const size_t jobs, const size_t threads, Job&& job) {
+    std::atomic<size_t> next { 0 };
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+    auto work = [&] {
+        for (size_t i = next++; i < jobs; i = next++) {
+            try {
+                job(i);
+            } catch (...) {
+                const std::lock_guard lock { failure_mutex };
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+            }
+        }
+    };
+    {
+        std::vector<std::jthread> pool;
+        for (size_t t = 1; t < std::min(threads, jobs); ++t) {
+            pool.emplace_back(work);
+        }
+        work();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+static void
+append_token(token_batch& to, const token_batch& from, const size_t index) {
+    to.kinds.push_back(from.kinds[index]);
+    to.offsets.push_back(from.offsets[index]);
+    to.lengths.push_back(from.lengths[index]);
+    to.lines.push_back(from.lines[index]);
+    to.columns.push_back(from.columns[index]);
+}
+
+/// Index of the token of @p tokens that starts at @p offset, or -1.
+static size_t
+find_start(const token_batch& tokens, const std::streamoff offset) {
+    const auto it = std::lower_bound(
+        tokens.offsets.begin(), tokens.offsets.end(), offset
+    );
+    if (it == tokens.offsets.end() || *it != offset) {
+        return static_cast<size_t>(-1);
+    }
+    return static_cast<size_t>(it - tokens.offsets.begin());
+}
+
+/// Offset just past the construct @p state says @p from is inside of, or -1
+/// when it does not end before @p limit. Stopping there keeps a long or
+/// unterminated construct from being scanned once per chunk it covers.
+static std::streamoff skip_construct(
+    std::string_view text, size_t from, const entry_state state,
+    const size_t limit
+) {
+    text = text.substr(0, limit);
+    switch (state) {
+    case entry_state::code:
+        return static_cast<std::streamoff>(from);
+    case entry_state::block_comment: {
+        const auto end = text.find("*/", from);
+        return end == std::string_view::npos
+            ? -1
+            : static_cast<std::streamoff>(end + 2);
+    }
+    case entry_state::line_comment: {
+        const auto end = text.find('\n', from);
+        return end == std::string_view::npos
+            ? -1
+            : static_cast<std::streamoff>(end + 1);
+    }
+    case entry_state::double_quoted:
+    case entry_state::single_quoted: {
+        const char quote = state == entry_state::double_quoted ? '"' : '\'';
+        while (from < text.size()) {
+            from += span_string_body(text.substr(from), quote);
+            if (from >= text.size()) {
+                break;
+            }
+            if (text[from] == quote) {
+                return static_cast<std::streamoff>(from + 1);
+            }
+            from += text[from] == '\\' ? 2U : 1U;
+        }
+        return -1;
+    }
+    }
+    return -1;
+}
+
+/**
+ * @brief Line starts of a chunked text, as far as chunk boundaries go.
+ *
+ * Only the position of each chunk start is stored; positions inside a
+ * chunk are counted from there, so building it is one parallel pass.
+ */
+class chunk_positions {
+public:
+    chunk_positions(
+        const std::string_view text, const size_t chunk_size,
+        const size_t chunks, const size_t threads
+    )
+        : text(text)
+        , chunk_size(chunk_size)
+        , starts(chunks) {
+        std::vector<size_t> newlines(chunks);
+        std::vector<size_t> last_newline(chunks);
+        run_parallel(chunks, threads, [&](const size_t k) {
+            const auto part = text.substr(k * chunk_size, chunk_size);
+            newlines[k] = count_newlines(part);
+            last_newline[k] = part.rfind('\n');
+        });
+        starts[0] = { 0, 0 };
+        for (size_t k = 1; k < chunks; ++k) {
+            const auto& previous = starts[k - 1];
+            starts[k].line
+                = previous.line + static_cast<int>(newlines[k - 1]);
+            starts[k].column = last_newline[k - 1] == std::string_view::npos
+                ? previous.column + static_cast<int>(chunk_size)
+                : static_cast<int>(chunk_size - last_newline[k - 1] - 1);
+        }
+    }
+
+    [[nodiscard]] text_position locate(const std::streamoff offset) const {
+        const auto k = std::min(
+            static_cast<size_t>(offset) / chunk_size, starts.size() - 1
+        );
+        const auto begin = k * chunk_size;
+        const auto part
+            = text.substr(begin, static_cast<size_t>(offset) - begin);
+        const auto last = part.rfind('\n');
+        return { starts[k].line + static_cast<int>(count_newlines(part)),
+                 last == std::string_view::npos
+                     ? starts[k].column + static_cast<int>(part.size())
+                     : static_cast<int>(part.size() - last - 1) };
+    }
+
+private:
+    std::string_view text;
+    size_t chunk_size;
+    std::vector<text_position> starts;
+};
+
+/**
+ * @brief Lex from @p start into @p out, stopping at the first token that
+ * starts at or after @p end.
+ *
+ * With @p code given, also stop at the first token that @p code has as
+ * well. Errors end the stream unless @p rethrow is set; an error before the
+ * first token just means @p start was no token start, and lexing is
+ * retried one byte later. @p r may only see the text up to @p cut: a token
+ * ending less than 4 bytes before it may have been cut short, as the reader
+ * looks at the whole UTF-8 sequence after an identifier, so it ends the
+ * stream like an error does, without a retry.
+ */
+static void lex_from(
+    reader& r, const chunk_positions& positions, std::streamoff start,
+    const std::streamoff end, lex_stream& out, const lex_stream* code,
+    const bool rethrow,
+    const std::streamoff cut = std::numeric_limits<std::streamoff>::max()
+) {
+    token_batch batch;
+    while (true) {
+        if (start >= end) {
+            out.exit = start;
+            return;
+        }
+        const auto at = positions.locate(start);
+        r.jump_to_position(start, at.line, at.column);
+        auto cursor = start;
+        bool failed = false;
+        bool cut_short = false;
+        while (!failed) {
+            try {
+                r.next_tokens(batch, code ? 16 : 256);
+            } catch (const std::runtime_error&) {
+                if (rethrow) {
+                    throw;
+                }
+                failed = true;
+            }
+            for (size_t i = 0; i < batch.size(); ++i) {
+                const auto offset = batch.offsets[i];
+                if (offset >= end) {
+                    out.exit = offset;
+                    return;
+                }
+                if (code) {
+                    const auto joined = find_start(code->tokens, offset);
+                    if (joined != static_cast<size_t>(-1)) {
+                        out.merge = joined;
+                        return;
+                    }
+                }
+                if (offset + batch.lengths[i] + 3 >= cut) {
+                    cut_short = failed = true;
+                    break;
+                }
+                append_token(out.tokens, batch, i);
+                cursor = offset + batch.lengths[i];
+                if (batch.kinds[i] == token_kind::eof) {
+                    out.exit = end;
+                    return;
+                }
+            }
+        }
+        if (!out.tokens.empty()) {
+            out.failed_at = cursor;
+            return;
+        }
+        if (cut_short) {
+            return;
+        }
+        start = cursor + 1;
+    }
+}
+
+parallel_lexer::parallel_lexer(const size_t threads, const size_t chunk_size)
+    : threads(
+          threads ? threads
+                  : std::max(1U, std::thread::hardware_concurrency())
+      )
+    , chunk_size(chunk_size) {
+    if (chunk_size == 0) {
+        throw std::invalid_argument("chunk size must be positive");
+    }
+}
+
+std::vector<token> parallel_lexer::lex(const std::string_view text) const {
+    const size_t chunks
+        = std::max<size_t>(1, (text.size() + chunk_size - 1) / chunk_size);
+    const auto chunk_start = [&](const size_t k) {
+        return static_cast<std::streamoff>(
+            std::min(k * chunk_size, text.size())
+        );
+    };
+    // the last chunk also owns the eof token, which starts at text.size()
+    const auto chunk_end = [&](const size_t k) {
+        return k + 1 == chunks ? static_cast<std::streamoff>(text.size()) + 1
+                               : chunk_start(k + 1);
+    };
+    const chunk_positions positions { text, chunk_size, chunks, threads };
+    const auto input = std::make_shared<view_source>(text);
+    // checked once here instead of by every reader of the chunks
+    const auto invalid = find_invalid_utf8(text);
+    const auto first_invalid = invalid == std::string_view::npos
+        ? std::numeric_limits<std::streamoff>::max()
+        : static_cast<std::streamoff>(invalid);
+
+    std::vector<std::array<lex_stream, entry_state_count>> streams(chunks);
+    run_parallel(chunks, threads, [&](const size_t k) {
+        // a chunk sees one more chunk of text, so a token running on past
+        // it is not lexed to its end once per chunk it covers
+        const auto seen = std::min(text.size(), (k + 2) * chunk_size);
+        const auto cut = seen < text.size()
+            ? static_cast<std::streamoff>(seen)
+            : std::numeric_limits<std::streamoff>::max();
+        reader r { std::make_shared<view_source>(text.substr(0, seen)),
+                   first_invalid };
+        auto& code = streams[k][0];
+        lex_from(
+            r, positions, chunk_start(k), chunk_end(k), code, nullptr, false,
+            cut
+        );
+        if (k == 0) {
+            return;
+        }
+        for (size_t s = 1; s < entry_state_count; ++s) {
+            const auto start = skip_construct(
+                text, static_cast<size_t>(chunk_start(k)),
+                static_cast<entry_state>(s), static_cast<size_t>(chunk_end(k))
+            );
+            if (start >= 0) {
+                lex_from(
+                    r, positions, start, chunk_end(k), streams[k][s], &code,
+                    false, cut
+                );
+            }
+        }
+    });
+
+    // prefix pass: follow the true token boundary from chunk to chunk
+    std::vector<lex_piece> pieces;
+    std::deque<lex_stream> relexed;
+    reader sequential { input, first_invalid };
+    std::streamoff boundary = 0;
+    for (size_t k = 0; k < chunks; ++k) {
+        if (boundary >= chunk_end(k)) {
+            continue;
+        }
+        const lex_stream* chosen = nullptr;
+        for (const auto& stream : streams[k]) {
+            const auto first = find_start(stream.tokens, boundary);
+            if (first == static_cast<size_t>(-1)) {
+                continue;
+            }
+            pieces.push_back({ &stream.tokens, first, stream.tokens.size() });
+            chosen = &stream;
+            if (stream.merge != static_cast<size_t>(-1)) {
+                chosen = &streams[k][0];
+                pieces.push_back(
+                    { &chosen->tokens, stream.merge, chosen->tokens.size() }
+                );
+            }
+            break;
+        }
+        if (chosen && chosen->failed_at < 0) {
+            boundary = chosen->exit;
+            continue;
+        }
+        if (chosen) {
+            boundary = chosen->failed_at;
+        }
+        // no stream fits, or the one that does hit an error: lex it again
+        // here, where an error is the first one in file order
+        auto& stream = relexed.emplace_back();
+        lex_from(
+            sequential, positions, boundary, chunk_end(k), stream, nullptr, true
+        );
+        pieces.push_back({ &stream.tokens, 0, stream.tokens.size() });
+        boundary = stream.exit;
+    }
+
+    std::vector<size_t> first_token(pieces.size() + 1);
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        first_token[i + 1] = first_token[i] + pieces[i].to - pieces[i].from;
+    }
+    std::vector<token> tokens(first_token.back());
+    run_parallel(pieces.size(), threads, [&](const size_t p) {
+        const auto& piece = pieces[p];
+        std::unique_ptr<reader> decoder;
+        for (size_t i = piece.from; i < piece.to; ++i) {
+            auto& t = tokens[first_token[p] + i - piece.from];
+            t.kind = piece.tokens->kinds[i];
+            t.line = piece.tokens->lines[i];
+            t.column = piece.tokens->columns[i];
+            t.file_offset = piece.tokens->offsets[i];
+            const auto raw = text.substr(
+                static_cast<size_t>(t.file_offset),
+                static_cast<size_t>(piece.tokens->lengths[i])
+            );
+            if (t.kind == token_kind::integer
+                || t.kind == token_kind::floating) {
+                t.word = raw;
+                t.value
+                    = decode_number(raw, t.kind == token_kind::floating);
+            } else if (t.kind == token_kind::keyword) {
+                t.word = raw;
+                t.keyword = classify_keyword(raw);
+            } else if (t.kind != token_kind::string) {
+                t.word = raw;
+            } else if (raw.find('\\') == std::string_view::npos) {
+                t.word = raw.substr(1, raw.size() - 2);
+            } else {
+                // escapes are rare; let the reader decode them
+                if (!decoder) {
+                    decoder = std::make_unique<reader>(input, first_invalid);
+                }
+                decoder->jump_to_position(t.file_offset, t.line, t.column);
+                decoder->next_token(t);
+            }
+        }
+    });
+    return tokens;
+}
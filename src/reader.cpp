@@ -24,46 +24,89 @@
 
 #include "reader.hpp"
 
+#include <algorithm>
 #include <cassert>
 
+#include "char_class.hpp"
+#include "operators.hpp"
+#include "scan.hpp"
+#include "uring_source.hpp"
+
 reader::reader(
     const std::filesystem::path& path, const std::streamsize buffer_size
 )
-    : max_buffer_size(buffer_size) {
-    ifs.open(path, std::ios::in | std::ios::binary);
-    if (!ifs.is_open()) {
-        throw std::invalid_argument("cannot open file: " + path.string());
+    : reader(path, read_mode::buffered, buffer_size) { }
+
+source_ptr open_source(
+    const std::filesystem::path& path, const read_mode mode,
+    const std::streamsize buffer_size, const std::streamsize max_buffer_size
+) {
+    switch (mode) {
+    case read_mode::buffered:
+        break;
+    case read_mode::mapped:
+        return std::make_shared<mapped_source>(path);
+    case read_mode::readahead:
+        return std::make_shared<readahead_source>(
+            std::make_shared<file_source>(path, buffer_size, max_buffer_size)
+        );
+    case read_mode::uring:
+        return make_uring_source(path, io_ring::create(4), buffer_size);
     }
-    ifs.seekg(0, std::ios::beg);
-    file_offset = ifs.tellg();
-    buffer.resize(static_cast<size_t>(max_buffer_size));
-    reload_buffer();
+    return std::make_shared<file_source>(path, buffer_size, max_buffer_size);
+}
+
+reader::reader(
+    const std::filesystem::path& path, const read_mode mode,
+    const std::streamsize buffer_size, const std::streamsize max_buffer_size
+)
+    : input(open_source(path, mode, buffer_size, max_buffer_size)) {
+    buffer = input->fetch(file_offset);
+    check_utf8();
 }
 
 reader::reader(std::string& data) noexcept
-    : buffer(std::move(data)) {
-    if (!buffer.empty()) {
-        line = 0;
-        column = 0;
+    : input(std::make_shared<memory_source>(std::move(data))) {
+    buffer = input->fetch(file_offset);
+    check_utf8();
+}
+
+reader::reader(source_ptr input)
+    : input(std::move(input)) {
+    if (!this->input) {
+        throw std::invalid_argument("reader requires a source");
+    }
+    buffer = this->input->fetch(file_offset);
+    check_utf8();
+}
+
+reader::reader(source_ptr input, const std::streamoff first_invalid)
+    : input(std::move(input))
+    , utf8_checked(std::numeric_limits<std::streamoff>::max())
+    , utf8_error(first_invalid) {
+    if (!this->input) {
+        throw std::invalid_argument("reader requires a source");
     }
+    buffer = this->input->fetch(file_offset);
 }
 
-reader::~reader() {
-    if (ifs.is_open()) {
-        ifs.close();
+std::shared_ptr<const void> reader::keep_alive() const noexcept {
+    if (!input->stable()) {
+        return nullptr;
     }
+    return input;
 }
 
 bool reader::is_valid() const noexcept {
     return !buffer.empty() && buffer_position < buffer.size();
 }
 
-char reader::peek_char() const noexcept { return buffer[buffer_position]; }
-
-unsigned char reader::peek_uchar() const noexcept {
-    return static_cast<unsigned char>(peek_char());
+std::streamoff reader::current_offset() const noexcept {
+    return file_offset + static_cast<std::streamoff>(buffer_position);
 }
 
+char reader::peek_char() const noexcept { return buffer[buffer_position]; }
+
 char reader::get_char() {
     const char current_char = peek_char();
     advance_char();
@@ -79,304 +122,749 @@ void reader::advance_char() {
     }
 }
 
+void reader::advance_run(const size_t length) {
+    assert(buffer_position + length <= buffer.size());
+    buffer_position += length;
+    column += static_cast<int>(length);
+    if (buffer_position >= buffer.size()) {
+        reload_buffer();
+    }
+}
+
 void reader::reload_buffer() {
-    if (!ifs.is_open() || ifs.eof()) {
+    if (capture) {
+        // slow path: the token crosses the window, keep what we have so far
+        capture->append(buffer.substr(capture_start));
+        capture_start = buffer.size();
+    }
+    const auto next = file_offset + static_cast<std::streamoff>(buffer.size());
+    const auto window = input->fetch(next);
+    if (window.empty()) {
+        if (next == utf8_checked && utf8.pending() > 0) {
+            // the input ends inside a multi-byte sequence
+            note_utf8_error(
+                utf8_checked - static_cast<std::streamoff>(utf8.pending())
+            );
+        }
         return;
     }
-    file_offset = ifs.tellg();
-    ifs.read(&buffer[0], max_buffer_size);
-    const auto got = ifs.gcount();
-    buffer.resize(static_cast<size_t>(got));
+    buffer = window;
+    file_offset = next;
     buffer_position = 0;
+    ++window_id;
+    capture_start = 0;
+    if (positions == position_mode::offsets) {
+        newlines.add(buffer, file_offset);
+    }
+    check_utf8();
 }
 
-void reader::read_whitespace(std::string& into) {
-    into.clear();
-    while (is_valid() && std::isspace(peek_uchar())) {
-        if (peek_char() == '\n') {
-            ++line;
-            column = -1;
+void reader::stitch_window(const size_t needed) {
+    // a multi-byte sequence is split between windows: copy the rest of this
+    // one, as fetching may overwrite it, and append whole windows, so that
+    // the next one still starts where this buffer ends
+    if (capture) {
+        capture->append(
+            buffer.data() + capture_start, buffer_position - capture_start
+        );
+        capture_start = buffer_position;
+    }
+    std::string joined { buffer.substr(buffer_position) };
+    const auto rest = joined.size();
+    auto next = file_offset + static_cast<std::streamoff>(buffer.size());
+    while (joined.size() < needed) {
+        const auto window = input->fetch(next);
+        if (window.empty()) {
+            break;
         }
-        into += get_char();
+        joined += window;
+        next += static_cast<std::streamoff>(window.size());
+    }
+    if (joined.size() == rest) {
+        return;
+    }
+    capture_start = 0;
+    file_offset = current_offset();
+    buffer_position = 0;
+    stitched = std::move(joined);
+    buffer = stitched;
+    ++window_id;
+    if (positions == position_mode::offsets) {
+        newlines.add(buffer, file_offset);
+    }
+    check_utf8();
+}
+
+size_t reader::identifier_code_point() {
+    if (!is_utf8_lead(peek_char())) {
+        return 0;
+    }
+    if (buffer.size() - buffer_position < 4) {
+        stitch_window(4);
+    }
+    return utf8_identifier_length(buffer.substr(buffer_position));
+}
+
+void reader::check_utf8() noexcept {
+    const auto end = file_offset + static_cast<std::streamoff>(buffer.size());
+    if (file_offset < utf8_checked_from || file_offset > utf8_checked) {
+        // a jump off the checked range: check on from here instead, with
+        // sequences carried across windows as usual; jumps land on token
+        // starts, so no sequence is cut
+        utf8.reset();
+        utf8_checked_from = utf8_checked = file_offset;
+    }
+    if (end <= utf8_checked) {
+        return;
+    }
+    const auto carried = static_cast<std::streamoff>(utf8.pending());
+    const auto bad = utf8.feed(
+        buffer.substr(static_cast<size_t>(utf8_checked - file_offset))
+    );
+    if (bad != std::string_view::npos) {
+        note_utf8_error(
+            bad == 0 && carried > 0
+                ? utf8_checked - carried
+                : utf8_checked + static_cast<std::streamoff>(bad)
+        );
+        utf8.reset();
+    }
+    utf8_checked = end;
+}
+
+void reader::note_utf8_error(const std::streamoff offset) noexcept {
+    utf8_error = std::min(utf8_error, offset);
+}
+
+void reader::throw_on_bad_utf8() const {
+    if (current_offset() > utf8_error) {
+        throw make_error(diagnostic_kind::invalid_utf8, utf8_error);
+    }
+}
+
+void reader::index_through(const std::streamoff end) {
+    // windows a jump skips over still have to be counted; this reuses the
+    // source's buffer, so the current window must be fetched again after
+    while (newlines.indexed_end() < end) {
+        const auto offset = newlines.indexed_end();
+        const auto window = input->fetch(offset);
+        if (window.empty()) {
+            break;
+        }
+        newlines.add(window, offset);
     }
 }
 
-void reader::read_keyword(std::string& into) {
-    into.clear();
-    do {
-        into += get_char();
-    } while (is_valid() && (std::isalnum(peek_uchar()) || peek_char() == '_'));
+void reader::begin_capture(std::string* into) noexcept {
+    capture = into;
+    capture_start = buffer_position;
 }
 
-void reader::read_comment(std::string& into) {
-    assert(is_valid() && into.size() == 1 && into[0] == '/');
-    into += get_char();
-    const bool is_multiline = into.back() == '*';
+void reader::end_capture() {
+    if (capture) {
+        capture->append(
+            buffer.data() + capture_start, buffer_position - capture_start
+        );
+        capture = nullptr;
+    }
+}
+
+void reader::advance_lines(const std::string_view run) {
+    if (positions == position_mode::offsets) {
+        advance_run(run.size());
+        return;
+    }
+    const auto newlines = count_newlines(run);
+    const auto last_newline = run.rfind('\n');
+    advance_run(run.size());
+    if (newlines != 0) {
+        line += static_cast<int>(newlines);
+        column = static_cast<int>(run.size() - last_newline - 1);
+    }
+}
+
+void reader::read_whitespace() {
+    while (is_valid() && is_space(peek_char())) {
+        const auto rest = buffer.substr(buffer_position);
+        advance_lines(rest.substr(0, span_whitespace(rest)));
+    }
+}
+
+void reader::read_keyword() {
     while (is_valid()) {
-        const char current_char = get_char();
-        if (is_multiline && current_char == '/' && into.back() == '*'
-            && into.size() > 2) {
-            into += current_char;
+        if (is_identifier(peek_char())) {
+            advance_run(span_identifier(buffer.substr(buffer_position)));
+        } else if (const auto length = identifier_code_point()) {
+            advance_run(length);
+        } else {
             return;
         }
-        into += current_char;
-        if (current_char == '\n') {
-            ++line;
-            column = -1;
-            if (!is_multiline) {
-                column = 0;
-                break;
+    }
+}
+
+void reader::read_digits() {
+    while (is_valid() && is_digit(peek_char())) {
+        advance_run(span_digits(buffer.substr(buffer_position)));
+    }
+}
+
+void reader::read_comment() {
+    assert(is_valid() && (peek_char() == '/' || peek_char() == '*'));
+    if (get_char() == '/') {
+        while (is_valid()) {
+            const auto rest = buffer.substr(buffer_position);
+            const auto end = rest.find('\n');
+            if (end == std::string_view::npos) {
+                advance_run(rest.size());
+                continue;
             }
+            advance_run(end + 1);
+            ++line;
+            column = 0;
+            break;
+        }
+        return;
+    }
+    // a '*' that ended the previous window may pair with a leading '/'
+    bool pending_star = false;
+    while (is_valid()) {
+        const auto rest = buffer.substr(buffer_position);
+        if (pending_star && rest.front() == '/') {
+            advance_char();
+            return;
         }
+        const auto end = rest.find("*/");
+        if (end != std::string_view::npos) {
+            advance_lines(rest.substr(0, end + 2));
+            return;
+        }
+        pending_star = rest.back() == '*';
+        advance_lines(rest);
     }
-    if (is_multiline) {
-        throw make_error("missing closing comment delimiter");
+    throw make_error(diagnostic_kind::missing_comment_end);
+}
+
+void reader::skip_trivia(std::vector<trivia_span>* trivia) {
+    while (is_valid()) {
+        const auto start = current_offset();
+        token_kind kind;
+        if (is_space(peek_char())) {
+            read_whitespace();
+            kind = token_kind::whitespace;
+        } else if (peek_char() == '/' && buffer_position + 1 < buffer.size()
+                   && (buffer[buffer_position + 1] == '/'
+                       || buffer[buffer_position + 1] == '*')) {
+            // a '/' that ends the window is left to read_token
+            advance_char();
+            read_comment();
+            kind = token_kind::comment;
+        } else {
+            return;
+        }
+        if (trivia) {
+            trivia->push_back({ kind, start, current_offset() - start });
+        }
+    }
+}
+
+static void append_utf8(std::string& out, const char32_t cp) {
+    if (cp <= 0x7F) {
+        out += static_cast<char>(cp);
+    } else if (cp <= 0x7FF) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp <= 0xFFFF) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
     }
 }
 
-void reader::read_string(std::string& into) {
-    into.clear();
+bool reader::read_string(std::string* into) {
     const char quote = get_char();
-    bool escaped = false;
+    bool decoded = false;
+    begin_capture(into);
     while (is_valid()) {
+        // escape-free text is one span up to the next quote, '\\' or '\n'
+        const auto rest = buffer.substr(buffer_position);
+        const auto run = span_string_body(rest, quote);
+        advance_run(run);
+        if (run == rest.size()) {
+            continue;
+        }
         const char current_char = peek_char();
-        if (escaped) {
-            switch (current_char) {
-            case '"':
-                into += '"';
-                break;
-            case '\'':
-                into += '\'';
-                break;
-            case '\\':
-                into += '\\';
-                break;
-            case '/':
-                into += '/';
-                break;
-            case 'b':
-                into += '\b';
-                break;
-            case 'f':
-                into += '\f';
-                break;
-            case 'n':
-                into += '\n';
-                break;
-            case 'r':
-                into += '\r';
-                break;
-            case 't':
-                into += '\t';
-                break;
-            case 'u': {
-                std::string hex;
-                for (int i = 0; i < 4; ++i) {
-                    advance_char();
-                    if (!is_valid() || !std::isxdigit(peek_uchar())) {
-                        throw make_error("invalid Unicode escape");
-                    }
-                    hex += peek_char();
-                }
-                // const int codepoint = std::stoi(hex, nullptr, 16);
-                // std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t>
-                //     converter;
-                // into += converter.to_bytes(static_cast<char32_t>(codepoint));
-                const auto codepoint
-                    = static_cast<char32_t>(std::stoul(hex, nullptr, 16));
-                auto encode = [](const char32_t cp) {
-                    std::string out;
-                    if (cp <= 0x7F) {
-                        out += static_cast<char>(cp);
-                    } else if (cp <= 0x7FF) {
-                        out += static_cast<char>(0xC0 | (cp >> 6));
-                        out += static_cast<char>(0x80 | (cp & 0x3F));
-                    } else if (cp <= 0xFFFF) {
-                        out += static_cast<char>(0xE0 | (cp >> 12));
-                        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
-                        out += static_cast<char>(0x80 | (cp & 0x3F));
-                    } else {
-                        out += static_cast<char>(0xF0 | (cp >> 18));
-                        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
-                        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
-                        out += static_cast<char>(0x80 | (cp & 0x3F));
-                    }
-                    return out;
-                };
-                into += encode(codepoint);
-                break;
-            }
-            default:
-                throw make_error("invalid escape sequence");
+        if (current_char == quote) {
+            end_capture();
+            advance_char();
+            return decoded;
+        }
+        if (current_char == '\n') {
+            advance_char();
+            ++line;
+            column = 0;
+            continue;
+        }
+        end_capture();
+        advance_char();
+        read_escape(into);
+        decoded = true;
+        begin_capture(into);
+    }
+    throw make_error(diagnostic_kind::missing_quote);
+}
+
+void reader::read_escape(std::string* into) {
+    if (!is_valid()) {
+        throw make_error(diagnostic_kind::missing_quote);
+    }
+    char decoded;
+    switch (const char current_char = peek_char()) {
+    case '"':
+    case '\'':
+    case '\\':
+    case '/':
+        decoded = current_char;
+        break;
+    case 'b':
+        decoded = '\b';
+        break;
+    case 'f':
+        decoded = '\f';
+        break;
+    case 'n':
+        decoded = '\n';
+        break;
+    case 'r':
+        decoded = '\r';
+        break;
+    case 't':
+        decoded = '\t';
+        break;
+    case 'u': {
+        char32_t codepoint = 0;
+        for (int i = 0; i < 4; ++i) {
+            advance_char();
+            if (!is_valid() || !is_hex_digit(peek_char())) {
+                throw make_error(diagnostic_kind::invalid_unicode_escape);
             }
-            escaped = false;
-        } else if (current_char == '\\') {
-            escaped = true;
-        } else if (current_char == quote) {
-            break;
-        } else {
-            into += current_char;
+            const char digit = peek_char();
+            const auto value = is_digit(digit)
+                ? digit - '0'
+                : (digit | 0x20) - 'a' + 10;
+            codepoint = (codepoint << 4) | static_cast<char32_t>(value);
         }
         advance_char();
+        if (into) {
+            append_utf8(*into, codepoint);
+        }
+        return;
     }
-    if (!is_valid() || peek_char() != quote) {
-        throw make_error("missing closing quote");
+    default:
+        throw make_error(diagnostic_kind::invalid_escape);
     }
     advance_char();
+    if (into) {
+        *into += decoded;
+    }
 }
 
-token_kind reader::read_number(std::string& into) {
-    into.clear();
+void reader::read_operator(std::uint8_t state) {
+    // operators are prefix-closed: the longest match ends where the DFA dies
+    while (state != 0 && is_valid()) {
+        state = operators.step(state, peek_char());
+        if (state != 0) {
+            advance_char();
+        }
+    }
+}
+
+token_kind reader::read_number() {
     bool is_float = false;
     if (is_valid() && peek_char() == '0') {
-        into += get_char();
-        if (is_valid() && std::isdigit(peek_uchar())) {
-            throw make_error("leading zeros not allowed");
+        advance_char();
+        if (is_valid() && is_digit(peek_char())) {
+            throw make_error(diagnostic_kind::leading_zeros);
         }
-    } else if (is_valid() && std::isdigit(peek_uchar())) {
-        do {
-            into += get_char();
-        } while (is_valid() && std::isdigit(peek_uchar()));
+    } else if (is_valid() && is_digit(peek_char())) {
+        read_digits();
     } else {
-        throw make_error("expected digit");
+        throw make_error(diagnostic_kind::expected_digit);
     }
 
     if (is_valid() && peek_char() == '.') {
         is_float = true;
-        into += get_char();
-        if (!is_valid() || !std::isdigit(peek_uchar())) {
-            throw make_error("digit expected after decimal");
-        }
-        while (is_valid() && std::isdigit(peek_uchar())) {
-            into += get_char();
+        advance_char();
+        if (!is_valid() || !is_digit(peek_char())) {
+            throw make_error(diagnostic_kind::digit_after_decimal);
         }
+        read_digits();
     }
 
     if (is_valid() && (peek_char() == 'e' || peek_char() == 'E')) {
         is_float = true;
-        into += get_char();
+        advance_char();
         if (is_valid() && (peek_char() == '+' || peek_char() == '-')) {
-            into += get_char();
-        }
-        if (!is_valid() || !std::isdigit(peek_uchar())) {
-            throw make_error("digit expected after exponent");
+            advance_char();
         }
-        while (is_valid() && std::isdigit(peek_uchar())) {
-            into += get_char();
+        if (!is_valid() || !is_digit(peek_char())) {
+            throw make_error(diagnostic_kind::digit_after_exponent);
         }
+        read_digits();
     }
     return is_float ? token_kind::floating : token_kind::integer;
 }
 
-void reader::init_token(token& t) const noexcept {
-    t.word.clear();
-    t.line = line;
-    t.column = column;
-    t.file_offset = file_offset + static_cast<std::streamoff>(buffer_position);
+token_kind reader::read_token(std::string* into, const comment_text comments) {
+    const auto kind = scan_token(into, comments);
+    throw_on_bad_utf8();
+    return kind;
 }
 
-std::runtime_error reader::make_error(
-    const std::string& message, const std::source_location& location
-) const {
-    std::ostringstream oss;
-    oss << "[Reader-Error] " << message << ". ";
-#ifndef NDEBUG
-    if (!ifs.is_open()) {
-        oss << "no file open. ";
-    }
+token_kind reader::scan_token(std::string* into, const comment_text comments) {
+    capture = nullptr; // a previous token may have thrown mid-capture
     if (!is_valid()) {
-        oss << "position is out of range. line: " << (line + 1)
-            << ", column: " << (column + 1) << " exceeds available input. ";
-    } else {
-        const char current_char = peek_char();
-        oss << "character '" << current_char
-            << "' (ASCII: " << static_cast<unsigned>(current_char)
-            << ") was found at line " << (line + 1) << ", column "
-            << (column + 1) << ". ";
+        return token_kind::eof;
     }
-    oss << "in file: " << location.file_name() << '(' << location.line() << ':'
-        << location.column() << ") `" << location.function_name() << "`";
-    oss << std::endl << buffer;
-#endif
-    return std::runtime_error(oss.str());
-}
-
-void reader::next_token(token& out) {
-    init_token(out);
-    out.kind = token_kind::special_character;
-
-    if (!is_valid()) {
-        out.kind = token_kind::eof;
-        out.word.clear();
-        return;
+    const char current_char = peek_char();
+    if (has_class(current_char, char_class::quote)) {
+        read_string(into);
+        return token_kind::string;
     }
-    switch (const char current_char = peek_char()) {
+    // everything but a string is its own raw text: scan first, copy once
+    begin_capture(into);
+    token_kind kind = token_kind::special_character;
+    switch (current_char) {
     case '(':
     case '[':
     case '{':
-        out.kind = token_kind::open_bracket;
-        out.word = std::string(1, get_char());
+        advance_char();
+        kind = token_kind::open_bracket;
         break;
     case ')':
     case ']':
     case '}':
-        out.kind = token_kind::close_bracket;
-        out.word = std::string(1, get_char());
+        advance_char();
+        kind = token_kind::close_bracket;
         break;
     case ',':
     case ';':
     case ':':
-        out.kind = token_kind::separator;
-        out.word = std::string(1, get_char());
+        advance_char();
+        kind = token_kind::separator;
         break;
     case '/':
-        out.word = std::string(1, get_char());
+        advance_char();
         if (is_valid() && (peek_char() == '/' || peek_char() == '*')) {
-            read_comment(out.word);
-            out.kind = token_kind::comment;
+            if (comments == comment_text::skip && into) {
+                // the sink starts empty; drop a '/' flushed by a reload
+                capture = nullptr;
+                into->clear();
+            }
+            read_comment();
+            kind = token_kind::comment;
+        } else {
+            read_operator(operators.step(1, '/'));
+        }
+        break;
+    default:
+        if (is_identifier_start(current_char)) {
+            read_keyword();
+            kind = token_kind::keyword;
+        } else if (is_digit(current_char)) {
+            kind = read_number();
+        } else if (is_space(current_char)) {
+            read_whitespace();
+            kind = token_kind::whitespace;
+        } else if (is_utf8_lead(current_char) && identifier_code_point()) {
+            read_keyword();
+            kind = token_kind::keyword;
+        } else if (current_offset() == 0
+                   && buffer.substr(buffer_position)
+                          .starts_with(byte_order_mark)) {
+            // a leading byte order mark only tells the encoding
+            advance_run(byte_order_mark.size());
+            kind = token_kind::whitespace;
+        } else if (is_utf8_lead(current_char)) {
+            // a code point that cannot be part of an identifier
+            do {
+                advance_char();
+            } while (is_valid() && is_utf8_continuation(peek_char()));
+        } else {
+            advance_char();
+            read_operator(operators.step(1, current_char));
+        }
+    }
+    end_capture();
+    return kind;
+}
+
+void reader::init_token(token& t) const noexcept {
+    const bool tracked = positions == position_mode::tracked;
+    t.word.clear();
+    if (t.value.index() != 0) {
+        t.value = {};
+    }
+    t.keyword = keyword_kind::identifier;
+    t.symbol = no_symbol;
+    t.line = tracked ? line : -1;
+    t.column = tracked ? column : -1;
+    t.file_offset = current_offset();
+}
+
+void reader::init_token(token_view& t) const noexcept {
+    t.word = {};
+    t.storage.clear();
+    if (t.value.index() != 0) {
+        t.value = {};
+    }
+    t.keyword = keyword_kind::identifier;
+    t.symbol = no_symbol;
+    t.line = positions == position_mode::tracked ? line : -1;
+    t.column = positions == position_mode::tracked ? column : -1;
+    t.file_offset = current_offset();
+}
+
+text_position reader::position_of(const std::streamoff at) const {
+    if (positions == position_mode::offsets) {
+        return newlines.locate(at);
+    }
+    const auto here = current_offset();
+    if (at < file_offset || at > here) {
+        return { -1, -1 };
+    }
+    // tracked positions are only known here: count back to at
+    const auto from = static_cast<size_t>(at - file_offset);
+    const auto between = buffer.substr(from, buffer_position - from);
+    const auto breaks = count_newlines(between);
+    if (breaks == 0) {
+        return { line, column - static_cast<int>(between.size()) };
+    }
+    // at's own line starts after the last '\n' before it in the window
+    auto line_start = from;
+    while (line_start > 0 && buffer[line_start - 1] != '\n') {
+        --line_start;
+    }
+    if (line_start == 0 && file_offset != 0) {
+        return { -1, -1 };
+    }
+    return { line - static_cast<int>(breaks),
+             static_cast<int>(from - line_start) };
+}
+
+source_excerpt reader::excerpt_at(const std::streamoff at) const noexcept {
+    source_excerpt excerpt;
+    const auto window_end
+        = file_offset + static_cast<std::streamoff>(buffer.size());
+    if (at < file_offset || at > window_end) {
+        return excerpt;
+    }
+    const auto width = excerpt.bytes.size();
+    const auto pos = static_cast<size_t>(at - file_offset);
+    auto first = pos;
+    while (first > 0 && buffer[first - 1] != '\n' && pos - first < width / 2) {
+        --first;
+    }
+    auto last = pos;
+    while (last < buffer.size() && buffer[last] != '\n'
+           && last - first < width) {
+        ++last;
+    }
+    const auto text = buffer.substr(first, last - first);
+    std::ranges::copy(text, excerpt.bytes.begin());
+    excerpt.length = static_cast<std::uint8_t>(last - first);
+    excerpt.caret = static_cast<std::uint8_t>(pos - first);
+    return excerpt;
+}
+
+diagnostic_error reader::make_error(
+    const diagnostic_kind kind, const std::source_location& location
+) const {
+    return make_error(kind, current_offset(), location);
+}
+
+diagnostic_error reader::make_error(
+    const diagnostic_kind kind, const std::streamoff at,
+    const std::source_location& location
+) const {
+    return diagnostic_error(
+        { kind, at, position_of(at), excerpt_at(at), location }
+    );
+}
+
+/// Fill in what the text of @p t decodes to: the value of a number, the
+/// sub-kind and, with a symbol table, the symbol of a keyword.
+template <typename Token>
+static void annotate_token(Token& t, symbol_table* symbols) {
+    switch (t.kind) {
+    case token_kind::integer:
+    case token_kind::floating:
+        t.value = decode_number(t.word, t.kind == token_kind::floating);
+        break;
+    case token_kind::keyword:
+        t.keyword = classify_keyword(t.word);
+        if (symbols) {
+            t.symbol = symbols->intern(t.word);
         }
         break;
     default:
-        if (std::isalpha(static_cast<unsigned char>(current_char))
-            || current_char == '_') {
-            read_keyword(out.word);
-            out.kind = token_kind::keyword;
-        } else if (std::isdigit(static_cast<unsigned char>(current_char))) {
-            out.kind = read_number(out.word);
-        } else if (current_char == '"' || current_char == '\'') {
-            read_string(out.word);
-            out.kind = token_kind::string;
-        } else if (std::isspace(static_cast<unsigned char>(current_char))) {
-            read_whitespace(out.word);
-            out.kind = token_kind::whitespace;
+        break;
+    }
+}
+
+void reader::next_token(token& out) {
+    init_token(out);
+    out.kind = read_token(&out.word);
+    annotate_token(out, symbols);
+}
+
+void reader::next_token(token_view& out, const comment_text comments) {
+    init_token(out);
+    if (!input->stable()) {
+        // the window may be refilled mid-token, so the text has to be copied
+        out.kind = read_token(&out.storage, comments);
+        out.word = out.storage;
+        annotate_token(out, symbols);
+        return;
+    }
+    const auto start = buffer_position;
+    if (is_valid() && has_class(peek_char(), char_class::quote)) {
+        out.kind = token_kind::string;
+        if (read_string(nullptr)) {
+            buffer_position = start;
+            line = out.line;
+            column = out.column;
+            read_string(&out.storage);
+            out.word = out.storage;
         } else {
-            out.word = std::string(1, get_char());
+            out.word = buffer.substr(start + 1, buffer_position - start - 2);
+        }
+        throw_on_bad_utf8();
+        return;
+    }
+    out.kind = read_token(nullptr, comments);
+    if (out.kind == token_kind::comment && comments == comment_text::skip) {
+        return;
+    }
+    out.word = buffer.substr(start, buffer_position - start);
+    annotate_token(out, symbols);
+}
+
+void reader::next_significant_token(
+    token_view& out, std::vector<trivia_span>* trivia
+) {
+    while (true) {
+        skip_trivia(trivia);
+        next_token(out, comment_text::skip);
+        if (out.kind != token_kind::whitespace
+            && out.kind != token_kind::comment) {
+            return;
+        }
+        if (trivia) {
+            const auto length = current_offset() - out.file_offset;
+            trivia->push_back({ out.kind, out.file_offset, length });
         }
     }
 }
 
+size_t reader::next_tokens(token_batch& out, const size_t count) {
+    const bool tracked = positions == position_mode::tracked;
+    out.resize(count);
+    size_t stored = 0;
+    try {
+        while (stored < count) {
+            out.offsets[stored] = current_offset();
+            out.lines[stored] = tracked ? line : -1;
+            out.columns[stored] = tracked ? column : -1;
+            const auto kind = read_token(nullptr);
+            out.kinds[stored] = kind;
+            out.lengths[stored] = current_offset() - out.offsets[stored];
+            ++stored;
+            if (kind == token_kind::eof) {
+                break;
+            }
+        }
+    } catch (...) {
+        out.resize(stored);
+        throw;
+    }
+    out.resize(stored);
+    return stored;
+}
+
+void reader::set_position_mode(const position_mode mode) {
+    if (current_offset() != 0) {
+        throw std::logic_error("position mode must be set before reading");
+    }
+    positions = mode;
+    newlines = {};
+    if (mode == position_mode::offsets) {
+        newlines.add(buffer, file_offset);
+    }
+}
+
+text_position reader::locate(const std::streamoff offset) const {
+    if (positions != position_mode::offsets) {
+        throw std::logic_error("locate needs position_mode::offsets");
+    }
+    return newlines.locate(offset);
+}
+
+const line_index& reader::lines() const noexcept { return newlines; }
+
 void reader::jump_to_position(
     const std::streamoff position, const int line, const int column
 ) {
-    if (position < 0) {
-        throw make_error("position is out of range");
+    const auto total = input->size();
+    if (position < 0 || (total >= 0 && position > total)) {
+        throw make_error(diagnostic_kind::position_out_of_range);
     }
-    if (!ifs.is_open()) {
-        buffer_position = static_cast<size_t>(position);
-        if (buffer_position > buffer.size()) {
-            throw make_error("position is out of range");
-        }
+    const auto window_end
+        = file_offset + static_cast<std::streamoff>(buffer.size());
+    if (position >= file_offset && position < window_end) {
+        buffer_position = static_cast<size_t>(position - file_offset);
     } else {
-        ifs.seekg(position, std::ios::beg);
-        reload_buffer();
+        if (positions == position_mode::offsets) {
+            index_through(position);
+        }
+        buffer = input->fetch(position);
+        file_offset = position;
+        buffer_position = 0;
+        ++window_id;
+        if (positions == position_mode::offsets) {
+            newlines.add(buffer, file_offset);
+        }
+        check_utf8();
     }
     this->line = line;
     this->column = column;
 }
 
+void reader::intern_symbols(symbol_table* table) noexcept {
+    symbols = table;
+}
+
+reader::checkpoint reader::save() const noexcept {
+    return { current_offset(), line, column, window_id };
+}
+
+void reader::restore(const checkpoint& point) {
+    if (point.window != window_id) {
+        jump_to_position(point.offset, point.line, point.column);
+        return;
+    }
+    buffer_position = static_cast<size_t>(point.offset - file_offset);
+    line = point.line;
+    column = point.column;
+}
+
 void reader::interrupt() {
-    if (ifs.is_open() && ifs.eof()) {
+    if (input->eof()) {
         return;
     }
-    throw make_error("interrupted");
+    throw make_error(diagnostic_kind::interrupted);
 }
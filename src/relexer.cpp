@@ -0,0 +1,236 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "relexer.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "reader.hpp"
+
+/**
+ * @brief How reused tokens move between the old and the new text.
+ *
+ * Offsets move by @ref offset and lines by @ref line. Columns only change
+ * on the line where lexing last caught up with the old tokens: @ref row is
+ * that line in the old text and @ref column the shift along it.
+ */
+struct token_shift {
+    std::streamoff offset { 0 };
+    int line { 0 };
+    int row { -1 };
+    int column { 0 };
+
+    [[nodiscard]] bool none() const noexcept {
+        return offset == 0 && line == 0 && column == 0;
+    }
+
+    [[nodiscard]] int column_of(const token& t) const noexcept {
+        return t.line == row ? t.column + column : t.column;
+    }
+
+    void apply(token& t) const noexcept {
+        t.column = column_of(t);
+        t.line += line;
+        t.file_offset += offset;
+    }
+};
+
+/// Bytes past its end the reader may look at to end a token: an identifier
+/// ends before a lead byte only once the whole sequence is seen.
+static constexpr std::streamoff token_lookahead = 3;
+
+/// Sort @p edits and check them against both texts.
+static void check_edits(
+    std::vector<text_edit>& edits, const std::streamoff old_size,
+    const size_t new_size
+) {
+    std::ranges::sort(edits, {}, &text_edit::offset);
+    auto size = old_size;
+    std::streamoff end = 0;
+    for (const auto& edit : edits) {
+        if (edit.offset < end || edit.removed < 0 || edit.inserted < 0
+            || edit.offset + edit.removed > old_size) {
+            throw std::invalid_argument(
+                "relex: edits overlap or lie outside the text"
+            );
+        }
+        end = edit.offset + edit.removed;
+        size += edit.inserted - edit.removed;
+    }
+    if (size != static_cast<std::streamoff>(new_size)) {
+        throw std::invalid_argument(
+            "relex: edits do not match the length of the new text"
+        );
+    }
+}
+
+std::vector<token> relex(
+    const std::string_view text, std::vector<token> previous,
+    std::vector<text_edit> edits, symbol_table* symbols
+) {
+    if (previous.empty() || previous.back().kind != token_kind::eof) {
+        throw std::invalid_argument("relex: old tokens must end with eof");
+    }
+    check_edits(edits, previous.back().file_offset, text.size());
+
+    reader r { std::make_shared<view_source>(text) };
+    r.intern_symbols(symbols);
+
+    // the result is built inside previous: tokens before write are final,
+    // tokens from next on still hold their old positions
+    size_t write = 0;
+    size_t next = 0;
+    token_shift shift;
+    std::vector<token> fresh;
+
+    // previous may have been interned into another table, or none: an id is
+    // kept only when it names the same word in symbols
+    const auto rebind = [&](token& t) {
+        if (t.kind != token_kind::keyword) {
+            return;
+        }
+        if (!symbols) {
+            t.symbol = no_symbol;
+        } else if (t.symbol >= symbols->size()
+                   || symbols->name(t.symbol) != t.word) {
+            t.symbol = symbols->intern(t.word);
+        }
+    };
+    const auto reuse = [&](const size_t end) {
+        if (write == next && shift.none()) {
+            for (; next < end; ++next) {
+                rebind(previous[next]);
+            }
+            write = next;
+            return;
+        }
+        for (; next < end; ++next, ++write) {
+            rebind(previous[next]);
+            shift.apply(previous[next]);
+            if (write != next) {
+                previous[write] = std::move(previous[next]);
+            }
+        }
+    };
+    // fresh takes the place of the old tokens before end
+    const auto replace = [&](size_t end) {
+        if (write + fresh.size() > end) {
+            const auto gap = static_cast<std::ptrdiff_t>(
+                write + fresh.size() - end
+            );
+            previous.resize(previous.size() + static_cast<size_t>(gap));
+            std::move_backward(
+                previous.begin() + static_cast<std::ptrdiff_t>(end),
+                previous.end() - gap, previous.end()
+            );
+            end += static_cast<size_t>(gap);
+        }
+        std::ranges::move(
+            fresh, previous.begin() + static_cast<std::ptrdiff_t>(write)
+        );
+        write += fresh.size();
+        next = end;
+    };
+    // first old token at or past old offset at that is not handled yet
+    const auto find = [&](const std::streamoff at) {
+        const auto it = std::lower_bound(
+            previous.begin() + static_cast<std::ptrdiff_t>(next),
+            previous.end(), at,
+            [](const token& t, const std::streamoff offset) {
+                return t.file_offset < offset;
+            }
+        );
+        return static_cast<size_t>(it - previous.begin());
+    };
+
+    size_t k = 0;
+    while (k < edits.size()) {
+        const auto first = find(edits[k].offset);
+        auto start = first > next ? first - 1 : next;
+        // the token before start ends where start begins
+        while (start > next
+               && previous[start].file_offset + token_lookahead
+                   >= edits[k].offset) {
+            --start;
+        }
+        reuse(start);
+        const auto& from = previous[start];
+        r.jump_to_position(
+            from.file_offset + shift.offset, from.line + shift.line,
+            shift.column_of(from)
+        );
+
+        // every edit a re-lexed token reaches is taken into this run
+        auto delta = shift.offset;
+        std::streamoff edited_end = 0;
+        const auto absorb = [&](const std::streamoff through) {
+            while (k < edits.size() && edits[k].offset + delta <= through) {
+                edited_end = edits[k].offset + delta + edits[k].inserted;
+                delta += edits[k].inserted - edits[k].removed;
+                ++k;
+            }
+        };
+        absorb(edits[k].offset + delta);
+
+        fresh.clear();
+        while (true) {
+            auto& t = fresh.emplace_back();
+            r.next_token(t);
+            if (t.kind == token_kind::eof) {
+                previous.erase(
+                    previous.begin() + static_cast<std::ptrdiff_t>(write),
+                    previous.end()
+                );
+                previous.insert(
+                    previous.end(), std::make_move_iterator(fresh.begin()),
+                    std::make_move_iterator(fresh.end())
+                );
+                return previous;
+            }
+            // the bytes that ended the token were read too, so an edit
+            // there changes the token
+            absorb(r.save().offset + token_lookahead);
+            if (t.file_offset < edited_end) {
+                continue;
+            }
+            const auto same = find(t.file_offset - delta);
+            if (same == previous.size()
+                || previous[same].file_offset != t.file_offset - delta) {
+                continue;
+            }
+            const auto& old = previous[same];
+            shift = { delta, t.line - old.line, old.line,
+                      t.column - old.column };
+            replace(same + 1);
+            break;
+        }
+    }
+    reuse(previous.size());
+    previous.erase(
+        previous.begin() + static_cast<std::ptrdiff_t>(write), previous.end()
+    );
+    return previous;
+}
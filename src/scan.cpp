@@ -0,0 +1,428 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "scan.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+struct whitespace_kernel {
+    static bool match(const char c) noexcept { return is_space(c); }
+
+#if defined(__SSE2__)
+    static __m128i match(const __m128i x) noexcept {
+        // '\t'..'\r' are contiguous: x - '\t' <= 4 (unsigned) catches them
+        const __m128i control = _mm_subs_epu8(
+            _mm_sub_epi8(x, _mm_set1_epi8('\t')), _mm_set1_epi8(4)
+        );
+        return _mm_or_si128(
+            _mm_cmpeq_epi8(control, _mm_setzero_si128()),
+            _mm_cmpeq_epi8(x, _mm_set1_epi8(' '))
+        );
+    }
+#endif
+
+#if defined(__AVX2__)
+    static __m256i match(const __m256i x) noexcept {
+        const __m256i control = _mm256_subs_epu8(
+            _mm256_sub_epi8(x, _mm256_set1_epi8('\t')), _mm256_set1_epi8(4)
+        );
+        return _mm256_or_si256(
+            _mm256_cmpeq_epi8(control, _mm256_setzero_si256()),
+            _mm256_cmpeq_epi8(x, _mm256_set1_epi8(' '))
+        );
+    }
+#endif
+};
+
+struct digit_kernel {
+    static bool match(const char c) noexcept { return is_digit(c); }
+
+#if defined(__SSE2__)
+    static __m128i match(const __m128i x) noexcept {
+        const __m128i offset = _mm_subs_epu8(
+            _mm_sub_epi8(x, _mm_set1_epi8('0')), _mm_set1_epi8(9)
+        );
+        return _mm_cmpeq_epi8(offset, _mm_setzero_si128());
+    }
+#endif
+
+#if defined(__AVX2__)
+    static __m256i match(const __m256i x) noexcept {
+        const __m256i offset = _mm256_subs_epu8(
+            _mm256_sub_epi8(x, _mm256_set1_epi8('0')), _mm256_set1_epi8(9)
+        );
+        return _mm256_cmpeq_epi8(offset, _mm256_setzero_si256());
+    }
+#endif
+};
+
+struct identifier_kernel {
+    static bool match(const char c) noexcept { return is_identifier(c); }
+
+#if defined(__SSE2__)
+    static __m128i match(const __m128i x) noexcept {
+        // folding to lower case keeps '@', '[', '`' and '{' out of a..z
+        const __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+        const __m128i letter = _mm_subs_epu8(
+            _mm_sub_epi8(lower, _mm_set1_epi8('a')), _mm_set1_epi8(25)
+        );
+        const __m128i digit = _mm_subs_epu8(
+            _mm_sub_epi8(x, _mm_set1_epi8('0')), _mm_set1_epi8(9)
+        );
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i ascii = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(letter, zero), _mm_cmpeq_epi8(digit, zero)
+            ),
+            _mm_cmpeq_epi8(x, _mm_set1_epi8('_'))
+        );
+        // UTF-8 bytes, less 0xC0..0xC3, 0xE2, 0xE3, 0xEF and 0xF5..0xFF
+        const __m128i excluded = _mm_or_si128(
+            _mm_or_si128(
+                _mm_or_si128(
+                    _mm_cmpeq_epi8(
+                        _mm_subs_epu8(
+                            _mm_sub_epi8(x, _mm_set1_epi8('\xC0')),
+                            _mm_set1_epi8(3)
+                        ),
+                        zero
+                    ),
+                    _mm_cmpeq_epi8(
+                        _mm_subs_epu8(
+                            _mm_sub_epi8(x, _mm_set1_epi8('\xE2')),
+                            _mm_set1_epi8(1)
+                        ),
+                        zero
+                    )
+                ),
+                _mm_cmpeq_epi8(x, _mm_set1_epi8('\xEF'))
+            ),
+            _mm_xor_si128(
+                _mm_cmpeq_epi8(
+                    _mm_subs_epu8(x, _mm_set1_epi8('\xF4')), zero
+                ),
+                _mm_set1_epi8(-1)
+            )
+        );
+        return _mm_or_si128(
+            ascii, _mm_andnot_si128(excluded, _mm_cmplt_epi8(x, zero))
+        );
+    }
+#endif
+
+#if defined(__AVX2__)
+    static __m256i match(const __m256i x) noexcept {
+        const __m256i lower = _mm256_or_si256(x, _mm256_set1_epi8(0x20));
+        const __m256i letter = _mm256_subs_epu8(
+            _mm256_sub_epi8(lower, _mm256_set1_epi8('a')), _mm256_set1_epi8(25)
+        );
+        const __m256i digit = _mm256_subs_epu8(
+            _mm256_sub_epi8(x, _mm256_set1_epi8('0')), _mm256_set1_epi8(9)
+        );
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i ascii = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(letter, zero),
+                _mm256_cmpeq_epi8(digit, zero)
+            ),
+            _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'))
+        );
+        const __m256i excluded = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(
+                        _mm256_subs_epu8(
+                            _mm256_sub_epi8(x, _mm256_set1_epi8('\xC0')),
+                            _mm256_set1_epi8(3)
+                        ),
+                        zero
+                    ),
+                    _mm256_cmpeq_epi8(
+                        _mm256_subs_epu8(
+                            _mm256_sub_epi8(x, _mm256_set1_epi8('\xE2')),
+                            _mm256_set1_epi8(1)
+                        ),
+                        zero
+                    )
+                ),
+                _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\xEF'))
+            ),
+            _mm256_xor_si256(
+                _mm256_cmpeq_epi8(
+                    _mm256_subs_epu8(x, _mm256_set1_epi8('\xF4')), zero
+                ),
+                _mm256_set1_epi8(-1)
+            )
+        );
+        return _mm256_or_si256(
+            ascii,
+            _mm256_andnot_si256(excluded, _mm256_cmpgt_epi8(zero, x))
+        );
+    }
+#endif
+};
+
+struct ascii_kernel {
+    static bool match(const char c) noexcept {
+        return static_cast<unsigned char>(c) < 0x80;
+    }
+
+#if defined(__SSE2__)
+    static __m128i match(const __m128i x) noexcept {
+        return _mm_cmpgt_epi8(x, _mm_set1_epi8(-1));
+    }
+#endif
+
+#if defined(__AVX2__)
+    static __m256i match(const __m256i x) noexcept {
+        return _mm256_cmpgt_epi8(x, _mm256_set1_epi8(-1));
+    }
+#endif
+};
+
+template <char Quote> struct string_body_kernel {
+    static bool match(const char c) noexcept {
+        return c != Quote && c != '\\' && c != '\n';
+    }
+
+#if defined(__SSE2__)
+    static __m128i match(const __m128i x) noexcept {
+        const __m128i stop = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(x, _mm_set1_epi8(Quote)),
+                _mm_cmpeq_epi8(x, _mm_set1_epi8('\\'))
+            ),
+            _mm_cmpeq_epi8(x, _mm_set1_epi8('\n'))
+        );
+        return _mm_cmpeq_epi8(stop, _mm_setzero_si128());
+    }
+#endif
+
+#if defined(__AVX2__)
+    static __m256i match(const __m256i x) noexcept {
+        const __m256i stop = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(x, _mm256_set1_epi8(Quote)),
+                _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\'))
+            ),
+            _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n'))
+        );
+        return _mm256_cmpeq_epi8(stop, _mm256_setzero_si256());
+    }
+#endif
+};
+
+template <typename Kernel>
+static size_t span(const std::string_view text) noexcept {
+    const char* const begin = text.data();
+    const char* const end = begin + text.size();
+    const char* p = begin;
+#if defined(__AVX2__)
+    for (; end - p >= 32; p += 32) {
+        const __m256i chunk
+            = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const auto hits = static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(Kernel::match(chunk))
+        );
+        if (hits != 0xFFFFFFFFU) {
+            return static_cast<size_t>(p - begin + std::countr_one(hits));
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    for (; end - p >= 16; p += 16) {
+        const __m128i chunk
+            = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const auto hits = static_cast<std::uint32_t>(
+            _mm_movemask_epi8(Kernel::match(chunk))
+        );
+        if (hits != 0xFFFFU) {
+            return static_cast<size_t>(p - begin + std::countr_one(hits));
+        }
+    }
+#endif
+    while (p != end && Kernel::match(*p)) {
+        ++p;
+    }
+    return static_cast<size_t>(p - begin);
+}
+
+size_t wide_span_whitespace(const std::string_view text) noexcept {
+    return span<whitespace_kernel>(text);
+}
+
+size_t wide_span_identifier(const std::string_view text) noexcept {
+    return span<identifier_kernel>(text);
+}
+
+size_t wide_span_digits(const std::string_view text) noexcept {
+    return span<digit_kernel>(text);
+}
+
+size_t
+wide_span_string_body(const std::string_view text, const char quote) noexcept {
+    if (quote == '"') {
+        return span<string_body_kernel<'"'>>(text);
+    }
+    return span<string_body_kernel<'\''>>(text);
+}
+
+size_t wide_count_newlines(const std::string_view text) noexcept {
+    const char* const end = text.data() + text.size();
+    const char* p = text.data();
+    size_t count = 0;
+#if defined(__AVX2__)
+    const __m256i newline32 = _mm256_set1_epi8('\n');
+    for (; end - p >= 32; p += 32) {
+        const __m256i chunk
+            = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        count += static_cast<size_t>(std::popcount(static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline32))
+        )));
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i newline16 = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16) {
+        const __m128i chunk
+            = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        count += static_cast<size_t>(std::popcount(static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline16))
+        )));
+    }
+#endif
+    return count + static_cast<size_t>(std::count(p, end, '\n'));
+}
+
+size_t wide_span_ascii(const std::string_view text) noexcept {
+    return span<ascii_kernel>(text);
+}
+
+static bool is_ascii(const char c) noexcept { return ascii_kernel::match(c); }
+
+/// Length of the UTF-8 sequence @p lead starts, 0 if it starts none.
+static size_t utf8_length(const unsigned char lead) noexcept {
+    if (lead < 0x80) {
+        return 1;
+    }
+    if (lead < 0xC2) {
+        return 0; // continuation byte, or overlong 0xC0/0xC1
+    }
+    if (lead < 0xE0) {
+        return 2;
+    }
+    if (lead < 0xF0) {
+        return 3;
+    }
+    return lead < 0xF5 ? 4 : 0;
+}
+
+/// True if the first @p count bytes of @p bytes, @p count at least 1, can
+/// start a valid sequence: no overlongs, surrogates or values past U+10FFFF.
+static bool
+utf8_prefix_valid(const unsigned char* bytes, const size_t count) noexcept {
+    const auto lead = bytes[0];
+    if (count > 1) {
+        const auto second = bytes[1];
+        auto low = static_cast<unsigned char>(0x80);
+        auto high = static_cast<unsigned char>(0xBF);
+        if (lead == 0xE0) {
+            low = 0xA0;
+        } else if (lead == 0xED) {
+            high = 0x9F;
+        } else if (lead == 0xF0) {
+            low = 0x90;
+        } else if (lead == 0xF4) {
+            high = 0x8F;
+        }
+        if (second < low || second > high) {
+            return false;
+        }
+    }
+    for (size_t i = 2; i < count; ++i) {
+        if ((bytes[i] & 0xC0U) != 0x80U) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t utf8_validator::feed(std::string_view text) noexcept {
+    size_t at = 0;
+    if (carried > 0) {
+        const auto length = utf8_length(carry[0]);
+        while (carried < length && at < text.size()) {
+            carry[carried++] = static_cast<unsigned char>(text[at++]);
+        }
+        if (!utf8_prefix_valid(carry, carried)) {
+            return 0;
+        }
+        if (carried < length) {
+            return std::string_view::npos;
+        }
+        carried = 0;
+    }
+    const auto* const bytes
+        = reinterpret_cast<const unsigned char*>(text.data());
+    while (at < text.size()) {
+        at += span_run<is_ascii, wide_span_ascii>(text.substr(at));
+        if (at == text.size()) {
+            break;
+        }
+        const auto length = utf8_length(bytes[at]);
+        if (length == 0) {
+            return at;
+        }
+        const auto available = std::min(length, text.size() - at);
+        if (!utf8_prefix_valid(bytes + at, available)) {
+            return at;
+        }
+        if (available < length) {
+            std::copy_n(bytes + at, available, carry);
+            carried = available;
+            break;
+        }
+        at += length;
+    }
+    return std::string_view::npos;
+}
+
+size_t utf8_validator::pending() const noexcept { return carried; }
+
+void utf8_validator::reset() noexcept { carried = 0; }
+
+size_t find_invalid_utf8(const std::string_view text) noexcept {
+    utf8_validator validator;
+    const auto bad = validator.feed(text);
+    if (bad == std::string_view::npos && validator.pending() > 0) {
+        return text.size() - validator.pending();
+    }
+    return bad;
+}
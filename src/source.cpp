@@ -0,0 +1,406 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "source.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+source::~source() = default;
+
+std::streamoff source::size() const noexcept { return -1; }
+
+bool source::is_open() const noexcept { return false; }
+
+bool source::eof() const noexcept { return false; }
+
+bool source::stable() const noexcept { return false; }
+
+file_source::file_source(
+    const std::filesystem::path& path, const std::streamsize buffer_size,
+    const std::streamsize max_buffer_size
+) {
+    if (buffer_size <= 0) {
+        throw std::invalid_argument("buffer size must be positive");
+    }
+    ifs.open(path, std::ios::in | std::ios::binary);
+    if (!ifs.is_open()) {
+        throw std::invalid_argument("cannot open file: " + path.string());
+    }
+    ifs.seekg(0, std::ios::end);
+    file_size = ifs.tellg();
+    ifs.seekg(0, std::ios::beg);
+    min_chunk = static_cast<size_t>(buffer_size);
+    max_chunk = std::max(min_chunk, static_cast<size_t>(max_buffer_size));
+    chunk = min_chunk;
+    buffer.resize(min_chunk);
+}
+
+std::string_view file_source::fetch(const std::streamoff offset) {
+    if (offset != position) {
+        ifs.clear();
+        ifs.seekg(offset, std::ios::beg);
+        position = offset;
+        chunk = min_chunk;
+    } else if (offset > 0 && chunk < max_chunk) {
+        chunk = std::min(chunk * 2, max_chunk);
+    }
+    if (ifs.eof()) {
+        return {};
+    }
+    const auto remaining = static_cast<size_t>(
+        std::max<std::streamoff>(file_size - position, 0)
+    );
+    const auto wanted = std::max(min_chunk, std::min(chunk, remaining));
+    if (buffer.size() < wanted) {
+        buffer.resize(wanted);
+    }
+    ifs.read(&buffer[0], static_cast<std::streamsize>(wanted));
+    const auto got = ifs.gcount();
+    position += got;
+    return { buffer.data(), static_cast<size_t>(got) };
+}
+
+std::streamoff file_source::size() const noexcept { return file_size; }
+
+bool file_source::is_open() const noexcept { return ifs.is_open(); }
+
+bool file_source::eof() const noexcept { return ifs.eof(); }
+
+memory_source::memory_source(std::string data) noexcept
+    : data(std::move(data)) { }
+
+std::string_view memory_source::fetch(const std::streamoff offset) {
+    const auto start = static_cast<size_t>(offset);
+    if (offset < 0 || start > data.size()) {
+        return {};
+    }
+    return std::string_view(data).substr(start);
+}
+
+std::streamoff memory_source::size() const noexcept {
+    return static_cast<std::streamoff>(data.size());
+}
+
+bool memory_source::stable() const noexcept { return true; }
+
+view_source::view_source(const std::string_view data) noexcept
+    : data(data) { }
+
+std::string_view view_source::fetch(const std::streamoff offset) {
+    const auto start = static_cast<size_t>(offset);
+    if (offset < 0 || start > data.size()) {
+        return {};
+    }
+    return data.substr(start);
+}
+
+std::streamoff view_source::size() const noexcept {
+    return static_cast<std::streamoff>(data.size());
+}
+
+bool view_source::stable() const noexcept { return true; }
+
+readahead_source::readahead_source(source_ptr inner)
+    : inner(std::move(inner)) {
+    if (!this->inner) {
+        throw std::invalid_argument("readahead_source requires a source");
+    }
+    total = this->inner->size();
+    open = this->inner->is_open();
+    worker = std::jthread([this](const std::stop_token stop) { run(stop); });
+}
+
+readahead_source::~readahead_source() = default;
+
+void readahead_source::run(const std::stop_token stop) {
+    std::unique_lock lock { mutex };
+    while (wake.wait(lock, stop, [this] { return requested >= 0; })) {
+        const auto offset = requested;
+        lock.unlock();
+        // back is ours until requested is cleared
+        const auto window = inner->fetch(offset);
+        back.assign(window);
+        lock.lock();
+        back_offset = offset;
+        requested = -1;
+        loaded.notify_all();
+    }
+}
+
+std::string_view readahead_source::fetch(const std::streamoff offset) {
+    std::unique_lock lock { mutex };
+    loaded.wait(lock, [this] { return requested < 0; });
+    if (back_offset != offset) {
+        // not the window we guessed; the worker is idle, so read it here
+        lock.unlock();
+        const auto window = inner->fetch(offset);
+        back.assign(window);
+        lock.lock();
+        back_offset = offset;
+    }
+    back_offset = -1;
+    if (back.empty()) {
+        // past the end: the caller keeps reading its window, so front stays
+        exhausted = true;
+        return {};
+    }
+    // the caller is done with front: it becomes the next back buffer
+    std::swap(front, back);
+    front_end = offset + static_cast<std::streamoff>(front.size());
+    exhausted = false;
+    if (total < 0 || front_end < total) {
+        requested = front_end;
+        wake.notify_one();
+    }
+    return front;
+}
+
+std::streamoff readahead_source::size() const noexcept { return total; }
+
+bool readahead_source::is_open() const noexcept { return open; }
+
+bool readahead_source::eof() const noexcept {
+    const std::lock_guard lock { mutex };
+    return exhausted || (total >= 0 && front_end >= total);
+}
+
+stream_source::stream_source(
+    std::istream& in, const std::streamsize buffer_size, const bool spill
+)
+    : in(in) {
+    if (buffer_size <= 0) {
+        throw std::invalid_argument("buffer size must be positive");
+    }
+    buffer.resize(static_cast<size_t>(buffer_size));
+    if (spill) {
+        this->spill = std::tmpfile();
+        if (!this->spill) {
+            throw std::runtime_error("cannot create spill file");
+        }
+    }
+}
+
+stream_source::~stream_source() {
+    if (spill) {
+        std::fclose(spill);
+    }
+}
+
+size_t stream_source::pull() {
+    if (ended) {
+        return 0;
+    }
+    in.read(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+    const auto got = static_cast<size_t>(in.gcount());
+    ended = !in;
+    if (spill && got > 0) {
+        if (std::fseek(spill, 0, SEEK_END) != 0
+            || std::fwrite(buffer.data(), 1, got, spill) != got) {
+            throw std::runtime_error("cannot write spill file");
+        }
+    }
+    streamed += static_cast<std::streamoff>(got);
+    return got;
+}
+
+std::string_view stream_source::fetch(const std::streamoff offset) {
+    if (offset < 0) {
+        return {};
+    }
+    std::string_view window;
+    if (offset < streamed) {
+        if (!spill) {
+            throw std::runtime_error("cannot seek back in a stream");
+        }
+        const auto length = std::min(
+            buffer.size(), static_cast<size_t>(streamed - offset)
+        );
+        if (std::fseek(spill, static_cast<long>(offset), SEEK_SET) != 0
+            || std::fread(&buffer[0], 1, length, spill) != length) {
+            throw std::runtime_error("cannot read spill file");
+        }
+        window = { buffer.data(), length };
+    } else {
+        auto start = streamed;
+        while (pull() > 0 && streamed <= offset) {
+            start = streamed;
+        }
+        if (offset < streamed) {
+            window = { buffer.data() + (offset - start),
+                       static_cast<size_t>(streamed - offset) };
+        }
+    }
+    delivered_end = offset + static_cast<std::streamoff>(window.size());
+    return window;
+}
+
+bool stream_source::is_open() const noexcept { return !in.bad(); }
+
+bool stream_source::eof() const noexcept {
+    return ended && delivered_end >= streamed;
+}
+
+block_cache_source::block_cache_source(
+    source_ptr inner, const size_t capacity, const size_t block_size
+)
+    : inner(std::move(inner))
+    , block_size(block_size)
+    , max_blocks(
+          block_size ? std::max<size_t>(2, capacity / block_size) : 0
+      ) {
+    if (!this->inner) {
+        throw std::invalid_argument("block_cache_source requires a source");
+    }
+    if (block_size == 0) {
+        throw std::invalid_argument("block size must be positive");
+    }
+}
+
+void block_cache_source::load(block& b) {
+    b.data.clear();
+    while (b.data.size() < block_size) {
+        const auto window = inner->fetch(
+            b.offset + static_cast<std::streamoff>(b.data.size())
+        );
+        if (window.empty()) {
+            break;
+        }
+        b.data.append(window.substr(0, block_size - b.data.size()));
+    }
+}
+
+std::string_view block_cache_source::fetch(const std::streamoff offset) {
+    if (offset < 0) {
+        return {};
+    }
+    const auto size = static_cast<std::streamoff>(block_size);
+    const auto aligned = offset - offset % size;
+    auto it = index.find(aligned);
+    if (it != index.end()) {
+        ++counters.hits;
+        blocks.splice(blocks.begin(), blocks, it->second);
+    } else {
+        ++counters.misses;
+        if (blocks.size() < max_blocks) {
+            blocks.emplace_front();
+        } else {
+            // recycle the least recently used block and its buffer
+            index.erase(blocks.back().offset);
+            blocks.splice(blocks.begin(), blocks, std::prev(blocks.end()));
+        }
+        blocks.front().offset = aligned;
+        load(blocks.front());
+        index[aligned] = blocks.begin();
+    }
+    const auto& data = blocks.front().data;
+    const auto start = static_cast<size_t>(offset - aligned);
+    const auto window = start < data.size()
+        ? std::string_view(data).substr(start)
+        : std::string_view();
+    delivered_end = offset + static_cast<std::streamoff>(window.size());
+    exhausted = window.empty();
+    return window;
+}
+
+std::streamoff block_cache_source::size() const noexcept {
+    return inner->size();
+}
+
+bool block_cache_source::is_open() const noexcept { return inner->is_open(); }
+
+bool block_cache_source::eof() const noexcept {
+    const auto total = inner->size();
+    return exhausted || (total >= 0 && delivered_end >= total);
+}
+
+cache_stats block_cache_source::stats() const noexcept { return counters; }
+
+#if defined(__unix__) || defined(__APPLE__)
+mapped_source::mapped_source(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::invalid_argument("cannot open file: " + path.string());
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::invalid_argument("cannot stat file: " + path.string());
+    }
+    const auto length = static_cast<size_t>(st.st_size);
+    if (length > 0) {
+        void* mapping
+            = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::invalid_argument("cannot map file: " + path.string());
+        }
+        ::madvise(mapping, length, MADV_SEQUENTIAL);
+        data = { static_cast<const char*>(mapping), length };
+    }
+    ::close(fd);
+}
+
+mapped_source::~mapped_source() {
+    if (!data.empty()) {
+        ::munmap(const_cast<char*>(data.data()), data.size());
+    }
+}
+#else
+mapped_source::mapped_source(const std::filesystem::path& path) {
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+    if (!ifs.is_open()) {
+        throw std::invalid_argument("cannot open file: " + path.string());
+    }
+    fallback.assign(std::istreambuf_iterator<char>(ifs), {});
+    data = fallback;
+}
+
+mapped_source::~mapped_source() = default;
+#endif
+
+std::string_view mapped_source::fetch(const std::streamoff offset) {
+    const auto start = static_cast<size_t>(offset);
+    if (offset < 0 || start > data.size()) {
+        return {};
+    }
+    return data.substr(start);
+}
+
+std::streamoff mapped_source::size() const noexcept {
+    return static_cast<std::streamoff>(data.size());
+}
+
+bool mapped_source::is_open() const noexcept { return true; }
+
+bool mapped_source::eof() const noexcept { return true; }
+
+bool mapped_source::stable() const noexcept { return true; }
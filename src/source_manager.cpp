@@ -0,0 +1,159 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "source_manager.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+file_id source_manager::add_file(
+    const std::filesystem::path& path, const read_mode mode
+) {
+    std::error_code error;
+    const auto canonical = std::filesystem::weakly_canonical(path, error);
+    if (error) {
+        throw std::invalid_argument("cannot open file: " + path.string());
+    }
+    const auto known = by_path.find(canonical.string());
+    if (known != by_path.end()) {
+        return known->second;
+    }
+    file_entry entry;
+    entry.name = path.string();
+    entry.path = canonical;
+    entry.mode = mode;
+    if (mode == read_mode::mapped) {
+        entry.input = open_source(canonical, mode);
+        entry.size = entry.input->size();
+    } else {
+        const auto size = std::filesystem::file_size(canonical, error);
+        if (error) {
+            throw std::invalid_argument("cannot open file: " + path.string());
+        }
+        entry.size = static_cast<std::streamoff>(size);
+    }
+    const auto id = add(std::move(entry));
+    by_path.emplace(canonical.string(), id);
+    return id;
+}
+
+file_id source_manager::add_source(std::string name, source_ptr input) {
+    if (!input) {
+        throw std::invalid_argument("source_manager requires a source");
+    }
+    if (input->size() < 0) {
+        throw std::invalid_argument(
+            "source_manager needs the size of " + name + " up front"
+        );
+    }
+    file_entry entry;
+    entry.name = std::move(name);
+    entry.size = input->size();
+    entry.input = std::move(input);
+    return add(std::move(entry));
+}
+
+file_id source_manager::add_buffer(std::string name, std::string text) {
+    return add_source(
+        std::move(name), std::make_shared<memory_source>(std::move(text))
+    );
+}
+
+file_id source_manager::add(file_entry entry) {
+    if (files.size() >= std::numeric_limits<file_id>::max()) {
+        throw std::length_error("source_manager: too many files");
+    }
+    entry.base = next_base;
+    // one past the eof position, so that it still belongs to this file
+    next_base += static_cast<global_offset>(entry.size) + 1;
+    bases.push_back(entry.base);
+    files.push_back(std::move(entry));
+    return static_cast<file_id>(files.size() - 1);
+}
+
+const source_manager::file_entry& source_manager::entry(const file_id file
+) const {
+    if (file >= files.size()) {
+        throw std::out_of_range("source_manager: unknown file id");
+    }
+    return files[file];
+}
+
+size_t source_manager::file_count() const noexcept { return files.size(); }
+
+const std::string& source_manager::name(const file_id file) const {
+    return entry(file).name;
+}
+
+std::streamoff source_manager::size(const file_id file) const {
+    return entry(file).size;
+}
+
+global_offset source_manager::base(const file_id file) const {
+    return entry(file).base;
+}
+
+global_offset source_manager::to_global(
+    const file_id file, const std::streamoff offset
+) const {
+    const auto& e = entry(file);
+    if (offset < 0 || offset > e.size) {
+        throw std::out_of_range("source_manager: offset outside the file");
+    }
+    return e.base + static_cast<global_offset>(offset);
+}
+
+file_id source_manager::file_of(const global_offset at) const {
+    if (at >= next_base) {
+        throw std::out_of_range("source_manager: offset past every file");
+    }
+    const auto after = std::ranges::upper_bound(bases, at);
+    return static_cast<file_id>(after - bases.begin() - 1);
+}
+
+global_position source_manager::locate(const global_offset at) const {
+    const auto file = file_of(at);
+    const auto& e = files[file];
+    if (!e.indexed) {
+        const auto input = open(file);
+        for (std::streamoff offset = 0;;) {
+            const auto window = input->fetch(offset);
+            if (window.empty()) {
+                break;
+            }
+            e.lines.add(window, offset);
+            offset += static_cast<std::streamoff>(window.size());
+        }
+        e.indexed = true;
+    }
+    const auto offset = static_cast<std::streamoff>(at - e.base);
+    return { file, offset, e.lines.locate(offset) };
+}
+
+source_ptr source_manager::open(const file_id file) const {
+    const auto& e = entry(file);
+    return e.input ? e.input : open_source(e.path, e.mode);
+}
@@ -0,0 +1,51 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "symbols.hpp"
+
+#include <stdexcept>
+
+symbol_table::symbol_table() {
+    for (const auto word : reserved_words) {
+        intern(word);
+    }
+}
+
+std::uint32_t symbol_table::intern(const std::string_view name) {
+    if (const auto it = ids.find(name); it != ids.end()) {
+        return it->second;
+    }
+    const auto id = static_cast<std::uint32_t>(names.size());
+    ids.emplace(names.emplace_back(name), id);
+    return id;
+}
+
+std::string_view symbol_table::name(const std::uint32_t id) const {
+    if (id >= names.size()) {
+        throw std::out_of_range("unknown symbol id");
+    }
+    return names[id];
+}
+
+size_t symbol_table::size() const noexcept { return names.size(); }
@@ -0,0 +1,443 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "token_cache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+#include "reader.hpp"
+
+/// Bumped whenever the entry layout or the tokens the reader makes change.
+static constexpr std::uint32_t entry_version = 1;
+
+static constexpr std::array<char, 8> entry_magic { 'Q', 'P', 'T', 'O',
+                                                   'K', 'E', 'N', 'S' };
+
+static constexpr std::string_view entry_extension = ".qtok";
+
+/**
+ * @brief Start of every entry.
+ *
+ * The header is followed by arrays, 64-bit ones first so that all stay
+ * aligned: token offsets, literal token indices and literal bits, then
+ * token kinds, keyword kinds and literal tags, one byte each. Integers are
+ * stored in the byte order of the machine that wrote them; an entry from
+ * another one fails the version check and is lexed again.
+ */
+struct entry_header {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t source_size;
+    std::uint64_t tokens;
+    std::uint64_t literals;
+};
+
+static_assert(sizeof(entry_header) == 40);
+
+/// How a literal's bits are to be read.
+enum class literal_tag : std::uint8_t {
+    integer = 1, ///< An int64_t
+    floating, ///< A double
+    big ///< Nothing; the text is decoded again
+};
+
+/// Byte offsets of the arrays of an entry with the given counts.
+struct entry_layout {
+    size_t offsets;
+    size_t literal_tokens;
+    size_t literal_bits;
+    size_t kinds;
+    size_t keywords;
+    size_t tags;
+    size_t size;
+
+    entry_layout(const size_t tokens, const size_t literals) noexcept
+        : offsets(sizeof(entry_header))
+        , literal_tokens(offsets + tokens * 8)
+        , literal_bits(literal_tokens + literals * 8)
+        , kinds(literal_bits + literals * 8)
+        , keywords(kinds + tokens)
+        , tags(keywords + tokens)
+        , size(tags + literals) { }
+};
+
+template <typename T>
+static T load(const std::string_view image, const size_t at) noexcept {
+    T value;
+    std::memcpy(&value, image.data() + at, sizeof(T));
+    return value;
+}
+
+template <typename T>
+static void append(std::string& image, const std::vector<T>& values) {
+    image.append(
+        reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T)
+    );
+}
+
+static std::uint64_t rotate(const std::uint64_t x, const int bits) noexcept {
+    return std::rotl(x, bits);
+}
+
+/// xxHash64-style hash of @p text: four lanes over 32-byte stripes.
+static std::uint64_t content_hash(const std::string_view text) noexcept {
+    constexpr std::uint64_t p1 = 0x9E3779B185EBCA87ULL;
+    constexpr std::uint64_t p2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr std::uint64_t p3 = 0x165667B19E3779F9ULL;
+    constexpr std::uint64_t p4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr std::uint64_t p5 = 0x27D4EB2F165667C5ULL;
+    constexpr std::uint64_t seed = entry_version;
+    const auto round = [&](const std::uint64_t acc, const std::uint64_t in) {
+        return rotate(acc + in * p2, 31) * p1;
+    };
+
+    size_t i = 0;
+    std::uint64_t h;
+    if (text.size() >= 32) {
+        std::array<std::uint64_t, 4> lanes { seed + p1 + p2, seed + p2, seed,
+                                             seed - p1 };
+        for (; i + 32 <= text.size(); i += 32) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                lanes[lane] = round(
+                    lanes[lane], load<std::uint64_t>(text, i + lane * 8)
+                );
+            }
+        }
+        h = rotate(lanes[0], 1) + rotate(lanes[1], 7) + rotate(lanes[2], 12)
+            + rotate(lanes[3], 18);
+        for (const auto lane : lanes) {
+            h = (h ^ round(0, lane)) * p1 + p4;
+        }
+    } else {
+        h = seed + p5;
+    }
+    h += text.size();
+    for (; i + 8 <= text.size(); i += 8) {
+        h = rotate(h ^ round(0, load<std::uint64_t>(text, i)), 27) * p1 + p4;
+    }
+    for (; i < text.size(); ++i) {
+        h = rotate(h ^ static_cast<std::uint8_t>(text[i]) * p5, 11) * p1;
+    }
+    h ^= h >> 33;
+    h *= p2;
+    h ^= h >> 29;
+    h *= p3;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * @brief Whether @p image is a whole entry of this version for a text of
+ * @p source_size bytes.
+ *
+ * Every record is checked before the entry is used, since a damaged or
+ * foreign file would otherwise hand out offsets past the text and kinds
+ * past the enums: offsets must tile the text from 0 up, eof must come
+ * last and only there, and each numeric token must own the next literal.
+ */
+static bool is_valid_entry(
+    const std::string_view image, const size_t source_size
+) noexcept {
+    if (image.size() < sizeof(entry_header)) {
+        return false;
+    }
+    const auto header = load<entry_header>(image, 0);
+    if (header.magic != entry_magic || header.version != entry_version
+        || header.source_size != source_size || header.tokens == 0
+        || header.literals > header.tokens
+        || header.tokens > image.size() / 8
+        || entry_layout(header.tokens, header.literals).size
+            != image.size()) {
+        return false;
+    }
+    const entry_layout layout { header.tokens, header.literals };
+    std::uint64_t previous = 0;
+    size_t literal = 0;
+    for (size_t i = 0; i < header.tokens; ++i) {
+        const auto offset = load<std::uint64_t>(image, layout.offsets + i * 8);
+        const auto kind = load<std::uint8_t>(image, layout.kinds + i);
+        const auto keyword = load<std::uint8_t>(image, layout.keywords + i);
+        if (offset < previous || offset > source_size
+            || (i == 0 && offset != 0)
+            || kind > static_cast<std::uint8_t>(token_kind::special_character)
+            || (kind == static_cast<std::uint8_t>(token_kind::eof))
+                != (i + 1 == header.tokens)
+            || keyword > static_cast<std::uint8_t>(keyword_kind::goto_kw)
+            || (keyword != 0
+                && kind != static_cast<std::uint8_t>(token_kind::keyword))) {
+            return false;
+        }
+        previous = offset;
+        if (kind != static_cast<std::uint8_t>(token_kind::integer)
+            && kind != static_cast<std::uint8_t>(token_kind::floating)) {
+            continue;
+        }
+        if (literal == header.literals
+            || load<std::uint64_t>(image, layout.literal_tokens + literal * 8)
+                != i) {
+            return false;
+        }
+        const auto tag = load<std::uint8_t>(image, layout.tags + literal);
+        if (tag < static_cast<std::uint8_t>(literal_tag::integer)
+            || tag > static_cast<std::uint8_t>(literal_tag::big)) {
+            return false;
+        }
+        ++literal;
+    }
+    return literal == header.literals && previous == source_size;
+}
+
+/// Lex @p text and lay its tokens out as an entry.
+static std::string make_entry(const std::string_view text) {
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint64_t> literal_tokens;
+    std::vector<std::uint64_t> literal_bits;
+    std::vector<token_kind> kinds;
+    std::vector<keyword_kind> keywords;
+    std::vector<literal_tag> tags;
+
+    const auto literal = [&](const literal_tag tag, const std::uint64_t bits) {
+        literal_tokens.push_back(offsets.size());
+        literal_bits.push_back(bits);
+        tags.push_back(tag);
+    };
+    reader r { std::make_shared<view_source>(text) };
+    token_view t;
+    do {
+        r.next_token(t, comment_text::skip);
+        if (const auto* integer = std::get_if<std::int64_t>(&t.value)) {
+            literal(literal_tag::integer, static_cast<std::uint64_t>(*integer));
+        } else if (const auto* floating = std::get_if<double>(&t.value)) {
+            literal(
+                literal_tag::floating, std::bit_cast<std::uint64_t>(*floating)
+            );
+        } else if (!std::holds_alternative<std::monostate>(t.value)) {
+            literal(literal_tag::big, 0);
+        }
+        offsets.push_back(static_cast<std::uint64_t>(t.file_offset));
+        kinds.push_back(t.kind);
+        keywords.push_back(t.keyword);
+    } while (t.kind != token_kind::eof);
+
+    const entry_header header { entry_magic,   entry_version, 0,
+                                text.size(),   offsets.size(),
+                                tags.size() };
+    std::string image;
+    image.reserve(entry_layout(offsets.size(), tags.size()).size);
+    image.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    append(image, offsets);
+    append(image, literal_tokens);
+    append(image, literal_bits);
+    for (const auto kind : kinds) {
+        image.push_back(static_cast<char>(kind));
+    }
+    append(image, keywords);
+    append(image, tags);
+    return image;
+}
+
+cached_tokens::cached_tokens(
+    std::shared_ptr<const void> storage, const std::string_view image,
+    const std::string_view source
+)
+    : storage(std::move(storage))
+    , image(image)
+    , source(source) {
+    const auto header = load<entry_header>(image, 0);
+    count = static_cast<size_t>(header.tokens);
+    literals = static_cast<size_t>(header.literals);
+}
+
+size_t cached_tokens::size() const noexcept { return count; }
+
+token_kind cached_tokens::kind(const size_t index) const {
+    return static_cast<token_kind>(
+        load<std::uint8_t>(image, entry_layout(count, literals).kinds + index)
+    );
+}
+
+keyword_kind cached_tokens::keyword(const size_t index) const {
+    return load<keyword_kind>(
+        image, entry_layout(count, literals).keywords + index
+    );
+}
+
+std::streamoff cached_tokens::offset(const size_t index) const {
+    return static_cast<std::streamoff>(load<std::uint64_t>(
+        image, entry_layout(count, literals).offsets + index * 8
+    ));
+}
+
+std::streamoff cached_tokens::length(const size_t index) const {
+    const auto end = index + 1 < count
+        ? offset(index + 1)
+        : static_cast<std::streamoff>(source.size());
+    return end - offset(index);
+}
+
+std::string_view cached_tokens::text(const size_t index) const {
+    return source.substr(
+        static_cast<size_t>(offset(index)), static_cast<size_t>(length(index))
+    );
+}
+
+number_value cached_tokens::value(const size_t index) const {
+    const auto k = kind(index);
+    if (k != token_kind::integer && k != token_kind::floating) {
+        return {};
+    }
+    // literal token indices are ascending: binary search them
+    const entry_layout layout { count, literals };
+    size_t low = 0;
+    size_t high = literals;
+    while (low < high) {
+        const auto middle = low + (high - low) / 2;
+        if (load<std::uint64_t>(image, layout.literal_tokens + middle * 8)
+            < index) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    const auto bits = load<std::uint64_t>(image, layout.literal_bits + low * 8);
+    switch (load<literal_tag>(image, layout.tags + low)) {
+    case literal_tag::integer:
+        return static_cast<std::int64_t>(bits);
+    case literal_tag::floating:
+        return std::bit_cast<double>(bits);
+    default:
+        return decode_number(text(index), k == token_kind::floating);
+    }
+}
+
+token_cache::token_cache(
+    std::filesystem::path directory, const std::uintmax_t capacity
+)
+    : directory(std::move(directory))
+    , capacity(capacity) {
+    std::filesystem::create_directories(this->directory);
+    trim();
+}
+
+std::filesystem::path token_cache::entry_path(const std::string_view text
+) const {
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(16)
+         << content_hash(text) << '-' << std::dec << text.size()
+         << entry_extension;
+    return directory / name.str();
+}
+
+cached_tokens token_cache::tokens_of(const std::string_view text) {
+    const auto path = entry_path(text);
+    std::error_code error;
+    if (std::filesystem::is_regular_file(path, error)) {
+        try {
+            const auto mapped = std::make_shared<mapped_source>(path);
+            const auto image = mapped->fetch(0);
+            if (is_valid_entry(image, text.size())) {
+                ++counters.hits;
+                std::filesystem::last_write_time(
+                    path, std::filesystem::file_time_type::clock::now(), error
+                );
+                return { mapped, image, text };
+            }
+        } catch (const std::invalid_argument&) {
+            // unreadable: replaced below like a stale entry
+        }
+    }
+    ++counters.misses;
+    const auto image = std::make_shared<const std::string>(make_entry(text));
+
+    // write next to the entry and rename, so readers never see half of it
+    const auto replaced = std::filesystem::file_size(path, error);
+    if (!error) {
+        used -= std::min(used, replaced);
+    }
+    auto temporary = path;
+    temporary += ".tmp" + std::to_string(std::random_device {}());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(image->data(), static_cast<std::streamsize>(image->size()));
+        out.close();
+        if (out) {
+            std::filesystem::rename(temporary, path, error);
+            if (!error) {
+                used += image->size();
+            }
+        }
+    }
+    std::filesystem::remove(temporary, error);
+    if (used > capacity) {
+        trim();
+    }
+    return { image, *image, text };
+}
+
+void token_cache::trim() {
+    struct entry {
+        std::filesystem::file_time_type used;
+        std::uintmax_t size;
+        std::filesystem::path path;
+    };
+    std::vector<entry> entries;
+    std::uintmax_t total = 0;
+    std::error_code error;
+    for (const auto& file :
+         std::filesystem::directory_iterator(directory, error)) {
+        if (file.path().extension() != entry_extension) {
+            continue;
+        }
+        const auto size = file.file_size(error);
+        const auto used = file.last_write_time(error);
+        if (!error) {
+            entries.push_back({ used, size, file.path() });
+            total += size;
+        }
+    }
+    if (total > capacity) {
+        std::ranges::sort(entries, {}, &entry::used);
+        for (const auto& e : entries) {
+            if (total <= capacity) {
+                break;
+            }
+            if (std::filesystem::remove(e.path, error)) {
+                total -= e.size;
+            }
+        }
+    }
+    used = total;
+}
+
+cache_stats token_cache::stats() const noexcept { return counters; }
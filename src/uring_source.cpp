@@ -0,0 +1,351 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "uring_source.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define QPILER_IO_URING 1
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(QPILER_IO_URING)
+template <typename T>
+static T* ring_field(void* map, const unsigned offset) noexcept {
+    return reinterpret_cast<T*>(static_cast<char*>(map) + offset);
+}
+
+static void* map_ring(const int fd, const size_t length, const off_t offset) {
+    void* const map = ::mmap(
+        nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        fd, offset
+    );
+    return map == MAP_FAILED ? nullptr : map;
+}
+
+std::shared_ptr<io_ring> io_ring::create(const unsigned entries) {
+    io_uring_params params {};
+    const auto fd
+        = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+        return nullptr;
+    }
+    std::shared_ptr<io_ring> ring { new io_ring() };
+    ring->ring_fd = fd;
+    ring->entries = params.sq_entries;
+    ring->sq_map_size
+        = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_map_size
+        = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_map) {
+        ring->sq_map_size = ring->cq_map_size
+            = std::max(ring->sq_map_size, ring->cq_map_size);
+    }
+    ring->sq_map = map_ring(fd, ring->sq_map_size, IORING_OFF_SQ_RING);
+    if (!ring->sq_map) {
+        return nullptr;
+    }
+    ring->cq_map = single_map
+        ? ring->sq_map
+        : map_ring(fd, ring->cq_map_size, IORING_OFF_CQ_RING);
+    ring->sqe_map_size = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqe_map = map_ring(fd, ring->sqe_map_size, IORING_OFF_SQES);
+    if (!ring->cq_map || !ring->sqe_map) {
+        return nullptr;
+    }
+    ring->sq_head = ring_field<unsigned>(ring->sq_map, params.sq_off.head);
+    ring->sq_tail = ring_field<unsigned>(ring->sq_map, params.sq_off.tail);
+    ring->sq_mask
+        = ring_field<unsigned>(ring->sq_map, params.sq_off.ring_mask);
+    ring->sq_array = ring_field<unsigned>(ring->sq_map, params.sq_off.array);
+    ring->cq_head = ring_field<unsigned>(ring->cq_map, params.cq_off.head);
+    ring->cq_tail = ring_field<unsigned>(ring->cq_map, params.cq_off.tail);
+    ring->cq_mask
+        = ring_field<unsigned>(ring->cq_map, params.cq_off.ring_mask);
+    ring->cqes = ring_field<void>(ring->cq_map, params.cq_off.cqes);
+    return ring;
+}
+
+io_ring::~io_ring() {
+    if (sqe_map) {
+        ::munmap(sqe_map, sqe_map_size);
+    }
+    if (cq_map && cq_map != sq_map) {
+        ::munmap(cq_map, cq_map_size);
+    }
+    if (sq_map) {
+        ::munmap(sq_map, sq_map_size);
+    }
+    ::close(ring_fd);
+}
+
+std::uint64_t io_ring::read(
+    const int fd, char* const into, const size_t length,
+    const std::streamoff offset
+) {
+    reap();
+    const unsigned tail = *sq_tail; // only this thread writes the tail
+    if (tail - std::atomic_ref(*sq_head).load(std::memory_order_acquire)
+        >= entries) {
+        submit();
+    }
+    const unsigned index = tail & *sq_mask;
+    auto* const sqe = static_cast<io_uring_sqe*>(sqe_map) + index;
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(into);
+    sqe->len = static_cast<unsigned>(length);
+    sqe->off = static_cast<std::uint64_t>(offset);
+    sqe->user_data = next_ticket;
+    sq_array[index] = index;
+    std::atomic_ref(*sq_tail).store(tail + 1, std::memory_order_release);
+    ++queued;
+    return next_ticket++;
+}
+
+void io_ring::enter(const unsigned submit, const unsigned wait_for) {
+    while (true) {
+        const auto done = ::syscall(
+            __NR_io_uring_enter, ring_fd, submit, wait_for,
+            wait_for ? IORING_ENTER_GETEVENTS : 0U, nullptr, 0
+        );
+        if (done >= 0) {
+            queued -= std::min(queued, static_cast<unsigned>(done));
+            return;
+        }
+        if (errno == EBUSY) {
+            // completion queue is full: make room and try again
+            reap();
+        } else if (errno != EINTR) {
+            throw std::runtime_error(
+                std::string("io_uring_enter failed: ") + std::strerror(errno)
+            );
+        }
+    }
+}
+
+void io_ring::submit() {
+    if (queued != 0) {
+        enter(queued, 0);
+    }
+}
+
+void io_ring::reap() {
+    unsigned head = *cq_head; // only this thread consumes completions
+    const unsigned tail
+        = std::atomic_ref(*cq_tail).load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+        const auto& cqe
+            = static_cast<const io_uring_cqe*>(cqes)[head & *cq_mask];
+        finished[cqe.user_data] = cqe.res;
+    }
+    std::atomic_ref(*cq_head).store(head, std::memory_order_release);
+}
+
+std::int64_t io_ring::wait(const std::uint64_t ticket) {
+    while (true) {
+        reap();
+        if (const auto it = finished.find(ticket); it != finished.end()) {
+            const auto result = it->second;
+            finished.erase(it);
+            return result;
+        }
+        enter(queued, 1);
+    }
+}
+
+uring_source::uring_source(
+    const std::filesystem::path& path, std::shared_ptr<io_ring> ring,
+    const std::streamsize buffer_size
+)
+    : ring(std::move(ring)) {
+    if (!this->ring) {
+        throw std::invalid_argument("uring_source requires an io_ring");
+    }
+    if (buffer_size <= 0) {
+        throw std::invalid_argument("buffer size must be positive");
+    }
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::invalid_argument("cannot open file: " + path.string());
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::invalid_argument("cannot stat file: " + path.string());
+    }
+    file_size = st.st_size;
+    for (auto& s : slots) {
+        s.buffer.resize(static_cast<size_t>(buffer_size));
+    }
+    // queued, not submitted: a batch goes to the kernel in one call
+    current = 1;
+    queue(slots[0], 0);
+}
+
+uring_source::~uring_source() {
+    for (auto& s : slots) {
+        if (s.ticket != 0) {
+            // the kernel may still write into the buffer
+            ring->wait(s.ticket);
+        }
+    }
+    ::close(fd);
+}
+
+void uring_source::queue(slot& s, const std::streamoff offset) {
+    s.offset = offset;
+    s.length = 0;
+    s.ticket = offset < file_size
+        ? ring->read(fd, s.buffer.data(), s.buffer.size(), offset)
+        : 0;
+}
+
+void uring_source::complete(slot& s) {
+    size_t got = 0;
+    if (s.ticket != 0) {
+        const auto result = ring->wait(s.ticket);
+        got = result > 0 ? static_cast<size_t>(result) : 0;
+        s.ticket = 0;
+    }
+    const auto want = s.offset < file_size
+        ? std::min(s.buffer.size(), static_cast<size_t>(file_size - s.offset))
+        : 0;
+    while (got < want) {
+        // failed or short ring read: finish it synchronously
+        const auto n = ::pread(
+            fd, s.buffer.data() + got, want - got,
+            static_cast<off_t>(s.offset) + static_cast<off_t>(got)
+        );
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        got += static_cast<size_t>(n);
+    }
+    s.length = got;
+}
+
+std::string_view uring_source::fetch(const std::streamoff offset) {
+    auto& next = slots[1 - current];
+    if (next.offset != offset) {
+        complete(next);
+        queue(next, offset);
+    }
+    complete(next);
+    current = 1 - current;
+    delivered_end = offset + static_cast<std::streamoff>(next.length);
+    exhausted = next.length == 0;
+    if (!exhausted && delivered_end < file_size) {
+        // the caller is done with the other buffer: read ahead into it
+        auto& ahead = slots[1 - current];
+        complete(ahead);
+        queue(ahead, delivered_end);
+        ring->submit();
+    }
+    return { next.buffer.data(), next.length };
+}
+
+bool uring_source::is_open() const noexcept { return fd >= 0; }
+#else
+std::shared_ptr<io_ring> io_ring::create(unsigned) { return nullptr; }
+
+io_ring::~io_ring() = default;
+
+std::uint64_t io_ring::read(int, char*, size_t, std::streamoff) { return 0; }
+
+void io_ring::submit() { }
+
+std::int64_t io_ring::wait(std::uint64_t) { return -1; }
+
+void io_ring::enter(unsigned, unsigned) { }
+
+void io_ring::reap() { }
+
+uring_source::uring_source(
+    const std::filesystem::path&, std::shared_ptr<io_ring>, std::streamsize
+) {
+    throw std::invalid_argument("io_uring is not available");
+}
+
+uring_source::~uring_source() = default;
+
+void uring_source::queue(slot&, std::streamoff) { }
+
+void uring_source::complete(slot&) { }
+
+std::string_view uring_source::fetch(std::streamoff) { return {}; }
+
+bool uring_source::is_open() const noexcept { return false; }
+#endif
+
+std::streamoff uring_source::size() const noexcept { return file_size; }
+
+bool uring_source::eof() const noexcept {
+    return exhausted || delivered_end >= file_size;
+}
+
+source_ptr make_uring_source(
+    const std::filesystem::path& path, std::shared_ptr<io_ring> ring,
+    const std::streamsize buffer_size
+) {
+    if (!ring) {
+        return std::make_shared<file_source>(path, buffer_size);
+    }
+    return std::make_shared<uring_source>(path, std::move(ring), buffer_size);
+}
+
+std::vector<source_ptr> open_uring_batch(
+    const std::vector<std::filesystem::path>& paths,
+    const std::streamsize buffer_size
+) {
+    // two windows per file in flight at most: the current and the next
+    const auto entries = static_cast<unsigned>(
+        std::clamp<size_t>(2 * paths.size(), 8, 256)
+    );
+    const auto ring = io_ring::create(entries);
+    std::vector<source_ptr> sources;
+    sources.reserve(paths.size());
+    for (const auto& path : paths) {
+        sources.push_back(make_uring_source(path, ring, buffer_size));
+    }
+    if (ring) {
+        ring->submit();
+    }
+    return sources;
+}
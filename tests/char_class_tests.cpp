@@ -0,0 +1,88 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "char_class.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cctype>
+
+TEST(CharClassTest, MatchesClassicLocale) {
+    for (int i = 0; i < 128; ++i) {
+        const auto c = static_cast<char>(i);
+        const auto u = static_cast<unsigned char>(i);
+        EXPECT_EQ(is_space(c), std::isspace(u) != 0) << i;
+        EXPECT_EQ(is_digit(c), std::isdigit(u) != 0) << i;
+        EXPECT_EQ(is_hex_digit(c), std::isxdigit(u) != 0) << i;
+        EXPECT_EQ(is_identifier_start(c), std::isalpha(u) != 0 || c == '_')
+            << i;
+        EXPECT_EQ(is_identifier(c), std::isalnum(u) != 0 || c == '_') << i;
+    }
+}
+
+TEST(CharClassTest, Utf8Identifiers) {
+    for (int i = 128; i < 256; ++i) {
+        const auto c = static_cast<char>(i);
+        EXPECT_FALSE(is_space(c)) << i;
+        EXPECT_FALSE(is_digit(c)) << i;
+        const bool lead = i >= 0xC4 && i <= 0xF4 && i != 0xE2 && i != 0xE3
+            && i != 0xEF;
+        EXPECT_EQ(is_identifier_start(c), lead) << i;
+        EXPECT_EQ(is_identifier(c), lead || i < 0xC0) << i;
+        EXPECT_EQ(is_utf8_lead(c), i >= 0xC0) << i;
+        EXPECT_EQ(is_utf8_continuation(c), i < 0xC0) << i;
+    }
+}
+
+TEST(CharClassTest, Utf8IdentifierCodePoints) {
+    // é, ж, 変, 々, Ｘ, ９, ＿ and 😀 qualify
+    for (const std::string_view letter :
+         { "\xc3\xa9", "\xd0\xb6", "\xe5\xa4\x89", "\xe3\x80\x85",
+           "\xef\xbc\xb8", "\xef\xbc\x99", "\xef\xbc\xbf",
+           "\xf0\x9f\x98\x80" }) {
+        EXPECT_EQ(utf8_identifier_length(letter), letter.size()) << letter;
+    }
+    // ·, ×, ÷, “, the ideographic space and full stop, ＝, ；, ｡ and the BOM
+    // do not, nor do cut or malformed sequences
+    for (const std::string_view other :
+         { "\xc2\xb7", "\xc3\x97", "\xc3\xb7", "\xe2\x80\x9c",
+           "\xe3\x80\x80", "\xe3\x80\x82", "\xef\xbc\x9d",
+           "\xef\xbc\x9b", "\xef\xbd\xa1", "\xef\xbb\xbf", "\xe5\xa4",
+           "\xc3\x28", "a", "" }) {
+        EXPECT_EQ(utf8_identifier_length(other), 0u) << other;
+    }
+}
+
+TEST(CharClassTest, Punctuation) {
+    for (const char c : { '(', ')', '[', ']', '{', '}' }) {
+        EXPECT_TRUE(has_class(c, char_class::bracket));
+    }
+    for (const char c : { ',', ';', ':' }) {
+        EXPECT_TRUE(has_class(c, char_class::separator));
+    }
+    EXPECT_TRUE(has_class('"', char_class::quote));
+    EXPECT_TRUE(has_class('\'', char_class::quote));
+    EXPECT_FALSE(has_class('/', char_class::bracket));
+    EXPECT_FALSE(has_class('`', char_class::quote));
+}
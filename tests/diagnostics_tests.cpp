@@ -0,0 +1,151 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "diagnostics.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+#include "reader.hpp"
+
+static diagnostic read_failure(
+    std::string text, const position_mode mode = position_mode::tracked
+) {
+    reader r { text };
+    r.set_position_mode(mode);
+    token t;
+    try {
+        do {
+            r.next_token(t);
+        } while (t.kind != token_kind::eof);
+    } catch (const diagnostic_error& e) {
+        return e.info();
+    }
+    ADD_FAILURE() << "no error";
+    return {};
+}
+
+TEST(DiagnosticsTest, ReaderErrorsCarryPosition) {
+    for (const auto mode : { position_mode::tracked, position_mode::offsets }) {
+        const auto info = read_failure("a = 1;\nb = 0123;", mode);
+        EXPECT_EQ(info.kind, diagnostic_kind::leading_zeros);
+        EXPECT_EQ(info.offset, 12);
+        EXPECT_EQ(info.position.line, 1);
+        EXPECT_EQ(info.position.column, 5);
+        EXPECT_EQ(info.excerpt.text(), "b = 0123;");
+        EXPECT_EQ(info.excerpt.caret, 5);
+    }
+}
+
+TEST(DiagnosticsTest, RendersOnlyWhenAsked) {
+    std::string text = "x = 'it\\q';";
+    reader r { text };
+    token t;
+    try {
+        do {
+            r.next_token(t);
+        } while (t.kind != token_kind::eof);
+        FAIL() << "no error";
+    } catch (const std::runtime_error& e) {
+        const std::string message = e.what();
+        EXPECT_EQ(message.rfind("[Reader-Error] line 1, column 9 ", 0), 0U)
+            << message;
+        EXPECT_NE(
+            message.find("(offset 8): invalid escape sequence\n"
+                         "    x = 'it\\q';\n"
+                         "            ^"),
+            std::string::npos
+        ) << message;
+        EXPECT_EQ(e.what(), e.what()); // rendered once, then kept
+    }
+}
+
+TEST(DiagnosticsTest, RendersOnceAcrossThreads) {
+    const diagnostic info = read_failure("a = 1;\nb = 0123;");
+    const diagnostic_error error { info };
+    const diagnostic_error copy = error;
+    std::vector<const char*> seen(8);
+    {
+        std::vector<std::jthread> threads;
+        for (size_t i = 0; i < seen.size(); ++i) {
+            threads.emplace_back([&, i] {
+                seen[i] = (i % 2 ? copy : error).what();
+            });
+        }
+    }
+    for (const auto* message : seen) {
+        EXPECT_EQ(message, seen[0]);
+    }
+    EXPECT_EQ(std::string(seen[0]).rfind("[Reader-Error] line 2", 0), 0U);
+}
+
+TEST(DiagnosticsTest, Utf8ErrorPointsAtBadByte) {
+    const auto info = read_failure("x = 1;\ny = \"a\xff\";");
+    EXPECT_EQ(info.kind, diagnostic_kind::invalid_utf8);
+    EXPECT_EQ(info.offset, 13);
+    EXPECT_EQ(info.position.line, 1);
+    EXPECT_EQ(info.position.column, 6);
+    EXPECT_EQ(info.excerpt.caret, 6);
+}
+
+TEST(DiagnosticsTest, ExcerptIsClippedAroundTheError) {
+    const std::string text = "// long\n" + std::string(150, 'x') + " = 1.e "
+        + std::string(100, 'y');
+    const auto info = read_failure(text);
+    EXPECT_EQ(info.kind, diagnostic_kind::digit_after_decimal);
+    EXPECT_EQ(info.excerpt.length, info.excerpt.bytes.size());
+    EXPECT_EQ(info.excerpt.caret, info.excerpt.bytes.size() / 2);
+    EXPECT_EQ(
+        info.excerpt.text(),
+        text.substr(static_cast<size_t>(info.offset) - 40, 80)
+    );
+}
+
+TEST(DiagnosticsTest, BatchCollectsEveryFailure) {
+    diagnostic_batch batch;
+    size_t clean = 0;
+    for (std::string text : { "a = 1;", "b = \"open", "c = 1e;", "d;" }) {
+        clean += batch.collect([&] {
+            reader r { text };
+            token t;
+            do {
+                r.next_token(t);
+            } while (t.kind != token_kind::eof);
+        }) ? 1U : 0U;
+    }
+    EXPECT_EQ(clean, 2U);
+    ASSERT_EQ(batch.size(), 2U);
+    EXPECT_EQ(batch.items()[0].kind, diagnostic_kind::missing_quote);
+    EXPECT_EQ(batch.items()[1].kind, diagnostic_kind::digit_after_exponent);
+    std::ostringstream os;
+    batch.render(os);
+    EXPECT_NE(os.str().find("missing closing quote"), std::string::npos);
+    EXPECT_NE(
+        os.str().find("digit expected after exponent"), std::string::npos
+    );
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+}
@@ -110,3 +110,21 @@ TEST(GrouperTest, LimitTooSmallThrows) {
         EXPECT_THROW(g.parse_group(), std::runtime_error);
     }
 }
+
+TEST(GrouperTest, TreeKeepsSourceAlive) {
+    group_ptr res;
+    {
+        std::string input = "{alpha;beta}";
+        reader r { input };
+        grouper g { r };
+        res = g.parse_group();
+    }
+    auto* body = dynamic_cast<const group_node*>(res->first());
+    ASSERT_NE(body, nullptr);
+    auto* cmd = dynamic_cast<group_node*>(body->nodes[0].get());
+    ASSERT_NE(cmd, nullptr);
+    auto* alpha = dynamic_cast<token_node*>(cmd->nodes[0].get());
+    ASSERT_NE(alpha, nullptr);
+    EXPECT_FALSE(alpha->value.owns());
+    EXPECT_EQ(alpha->value.word, "alpha");
+}
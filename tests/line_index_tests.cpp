@@ -0,0 +1,70 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "line_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+TEST(LineIndexTest, LocatesEveryOffset) {
+    std::mt19937 rng { 7 };
+    std::string text;
+    for (int i = 0; i < 2000; ++i) {
+        text += rng() % 5 == 0 ? '\n' : 'x';
+    }
+    // uneven, overlapping windows, as a reader re-fetching after a jump
+    line_index index;
+    for (size_t offset = 0; offset < text.size(); offset += 37) {
+        index.add(
+            std::string_view(text).substr(offset, 50),
+            static_cast<std::streamoff>(offset)
+        );
+    }
+    EXPECT_EQ(index.indexed_end(), static_cast<std::streamoff>(text.size()));
+    int line = 0;
+    int column = 0;
+    for (size_t offset = 0; offset < text.size(); ++offset) {
+        const auto at = index.locate(static_cast<std::streamoff>(offset));
+        EXPECT_EQ(at.line, line);
+        EXPECT_EQ(at.column, column);
+        if (text[offset] == '\n') {
+            ++line;
+            column = 0;
+        } else {
+            ++column;
+        }
+    }
+    EXPECT_EQ(index.line_count(), static_cast<size_t>(line + 1));
+}
+
+TEST(LineIndexTest, RejectsGaps) {
+    line_index index;
+    index.add("a\nb", 0);
+    EXPECT_THROW(index.add("c", 4), std::invalid_argument);
+    EXPECT_THROW((void)index.locate(-1), std::out_of_range);
+    EXPECT_EQ(index.locate(3).line, 1);
+    EXPECT_EQ(index.locate(3).column, 1);
+}
@@ -0,0 +1,77 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "number.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(NumberTest, MachineIntegers) {
+    EXPECT_EQ(std::get<std::int64_t>(decode_number("0", false)), 0);
+    EXPECT_EQ(std::get<std::int64_t>(decode_number("73", false)), 73);
+    EXPECT_EQ(
+        std::get<std::int64_t>(decode_number("9223372036854775807", false)),
+        INT64_MAX
+    );
+}
+
+TEST(NumberTest, MachineDoubles) {
+    EXPECT_EQ(std::get<double>(decode_number("36.6", true)), 36.6);
+    EXPECT_EQ(std::get<double>(decode_number("0e123", true)), 0.0);
+    EXPECT_EQ(std::get<double>(decode_number("168E+012", true)), 168e12);
+    EXPECT_EQ(std::get<double>(decode_number("42E-67", true)), 42e-67);
+}
+
+TEST(NumberTest, OverflowFallsBackToBigNumber) {
+    const auto value = decode_number("9223372036854775808", false);
+    const auto& big = *std::get<std::shared_ptr<const big_number>>(value);
+    EXPECT_EQ(big.limbs, (std::vector<std::uint32_t> { 0, 0x80000000U }));
+    EXPECT_EQ(big.to_string(), "9223372036854775808");
+
+    const std::string nines(1024, '9');
+    const auto huge = std::get<std::shared_ptr<const big_number>>(
+        decode_number(nines, false)
+    );
+    EXPECT_EQ(huge->to_string(), nines);
+    EXPECT_EQ(huge->limbs.size(), 107u);
+}
+
+TEST(NumberTest, BigNumbersAreNormalized) {
+    EXPECT_EQ(big_number::parse("73e+789").to_string(), "73e789");
+    EXPECT_EQ(big_number::parse("15e-345").to_string(), "15e-345");
+    EXPECT_EQ(big_number::parse("1200.0500").to_string(), "120005e-2");
+    EXPECT_EQ(big_number::parse("0.000").to_string(), "0");
+    EXPECT_EQ(big_number::parse("100e-2"), big_number::parse("1.0"));
+    EXPECT_EQ(
+        big_number::parse(std::string(512, '9') + "." + std::string(511, '9'))
+            .to_string(),
+        std::string(1023, '9') + "e-511"
+    );
+    for (const std::string literal : { "1E456", "15e-345", "73e+789" }) {
+        EXPECT_TRUE(std::holds_alternative<std::shared_ptr<const big_number>>(
+            decode_number(literal, true)
+        ));
+    }
+}
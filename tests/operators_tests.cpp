@@ -0,0 +1,49 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "operators.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(OperatorsTest, EverySpellingIsMatched) {
+    for (const auto spelling : operator_spellings) {
+        EXPECT_EQ(span_operator(spelling), spelling.size()) << spelling;
+        EXPECT_EQ(span_operator(std::string(spelling) + "x"), spelling.size())
+            << spelling;
+    }
+}
+
+TEST(OperatorsTest, LongestMatch) {
+    EXPECT_EQ(span_operator("<<=b"), 3u);
+    EXPECT_EQ(span_operator("<<<"), 2u);
+    EXPECT_EQ(span_operator("+++"), 2u);
+    EXPECT_EQ(span_operator("-->"), 2u);
+    EXPECT_EQ(span_operator("!!"), 1u);
+    EXPECT_EQ(span_operator("=>"), 1u);
+    for (const std::string_view text : { "", "a", "1", "(", ":", "@", "#" }) {
+        EXPECT_EQ(span_operator(text), 0u) << text;
+    }
+}
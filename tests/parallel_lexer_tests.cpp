@@ -0,0 +1,140 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "parallel_lexer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iomanip>
+
+#include "reader.hpp"
+
+static std::vector<token> lex_sequential(const std::string& text) {
+    std::string data = text;
+    reader r { data };
+    std::vector<token> tokens;
+    do {
+        r.next_token(tokens.emplace_back());
+    } while (tokens.back().kind != token_kind::eof);
+    return tokens;
+}
+
+static void expect_same_tokens(
+    const std::vector<token>& got, const std::vector<token>& want
+) {
+    ASSERT_EQ(got.size(), want.size());
+    for (size_t i = 0; i < want.size(); ++i) {
+        EXPECT_EQ(got[i].kind, want[i].kind) << "token " << i;
+        EXPECT_EQ(got[i].word, want[i].word) << "token " << i;
+        EXPECT_EQ(got[i].line, want[i].line) << "token " << i;
+        EXPECT_EQ(got[i].column, want[i].column) << "token " << i;
+        EXPECT_EQ(got[i].file_offset, want[i].file_offset) << "token " << i;
+    }
+}
+
+TEST(ParallelLexerTest, MatchesReaderOnCorpus) {
+    std::string text;
+    for (int i = 0; i < 12; ++i) {
+        std::ostringstream path;
+        path << "test_data/test" << std::setfill('0') << std::setw(2) << i
+             << ".qc";
+        std::ifstream ifs(path.str(), std::ios::binary);
+        text.append(std::istreambuf_iterator<char>(ifs), {});
+    }
+    const auto want = lex_sequential(text);
+    for (const size_t chunk_size : { 1U, 2U, 3U, 7U, 64U, 100000U }) {
+        SCOPED_TRACE(chunk_size);
+        expect_same_tokens(parallel_lexer(4, chunk_size).lex(text), want);
+    }
+}
+
+TEST(ParallelLexerTest, ChunksStartingInsideTokens) {
+    const std::string text
+        = "\xef\xbb\xbf\xe5\xa4\x89\xe3\x80\x80\xef\xbc\x9d\xc3\xa9\xc3\x97"
+          "\xef\xbc\xa1;\n"
+          "\xef\xbc\xa1\xef\xbc\xa2 a\xef\xbc\xa1\xef\xbc\xa2 b "
+          "\xe5\xa4\x89\xe6\x95\xb0x\xe3\x80\x85\xc3\xa9;\n"
+          "x = \"a /* not a comment */ \\\" // \\u00e9\";\n"
+          "/* \"not a string\" ' */ y = 'it''s';\n"
+          "// \"'/* line\nz = 1000.25e+3 + 0.5;\n\"multi\nline\"";
+    const auto want = lex_sequential(text);
+    for (size_t chunk_size = 1; chunk_size <= text.size(); ++chunk_size) {
+        SCOPED_TRACE(chunk_size);
+        expect_same_tokens(parallel_lexer(3, chunk_size).lex(text), want);
+    }
+}
+
+TEST(ParallelLexerTest, ConstructsSpanningManyChunks) {
+    const std::string body(2000, 'x');
+    for (const std::string& text :
+         { "a /*" + body + "*/ b", "s = \"" + body + "\";", "// " + body,
+           "t = '" + body + "\n" + body + "' + \"\xc3\xa9\"",
+           "y = " + body + " + 1" }) {
+        const auto want = lex_sequential(text);
+        for (const size_t chunk_size : { 16U, 100U, 999U }) {
+            SCOPED_TRACE(chunk_size);
+            expect_same_tokens(parallel_lexer(3, chunk_size).lex(text), want);
+        }
+    }
+}
+
+TEST(ParallelLexerTest, IdentifiersEndingNearTheCut) {
+    for (const std::string text :
+         { "\xef\xbc\xa1\xef\xbc\xa2", "a\xef\xbc\xa1\xef\xbc\xa2 b",
+           "\xc3\xa9\xc3\xa9\xc3\xa9\xe3\x80\x85\xf0\x9f\x98\x80" }) {
+        const auto want = lex_sequential(text);
+        for (size_t chunk_size = 1; chunk_size <= text.size(); ++chunk_size) {
+            SCOPED_TRACE(chunk_size);
+            expect_same_tokens(parallel_lexer(1, chunk_size).lex(text), want);
+        }
+    }
+}
+
+TEST(ParallelLexerTest, EmptyInput) {
+    expect_same_tokens(parallel_lexer(2, 16).lex(""), lex_sequential(""));
+}
+
+TEST(ParallelLexerTest, ReportsFirstError) {
+    const std::vector<std::string> texts
+        = { "a = 'ok'; b = 0123; c = \"open", "a /* b", "x = \"\\q\"",
+            "a /* " + std::string(3000, 'x'), "x = 1; y = \"\xff\";" };
+    for (const auto& text : texts) {
+        std::string message;
+        try {
+            (void)lex_sequential(text);
+        } catch (const std::runtime_error& e) {
+            message = e.what();
+        }
+        ASSERT_FALSE(message.empty());
+        for (const size_t chunk_size : { 1U, 4U, 9U, 1000U }) {
+            try {
+                (void)parallel_lexer(2, chunk_size).lex(text);
+                ADD_FAILURE() << "no error for chunk size " << chunk_size;
+            } catch (const std::runtime_error& e) {
+                EXPECT_EQ(e.what(), message);
+            }
+        }
+    }
+}
@@ -48,11 +48,20 @@ TEST(ReaderTest, GoodIntegerToken) {
     for (std::string& str :
          std::vector<std::string> { "0", "1", "73", "2147483647", "1234567890",
                                     std::string(1024, '9') }) {
+        const std::string text = str;
         reader r { str };
         r.next_token(t);
         EXPECT_EQ(t.kind, token_kind::integer);
+        if (text.size() < 19) {
+            EXPECT_EQ(std::get<std::int64_t>(t.value), std::stoll(text));
+        } else {
+            const auto& big
+                = std::get<std::shared_ptr<const big_number>>(t.value);
+            EXPECT_EQ(big->to_string(), text);
+        }
         r.next_token(t);
         EXPECT_EQ(t.kind, token_kind::eof);
+        EXPECT_TRUE(std::holds_alternative<std::monostate>(t.value));
     }
 }
 
@@ -180,3 +189,651 @@ TEST(ReaderTest, CommentToken) {
     r.next_token(t);
     EXPECT_EQ(t.kind, token_kind::eof);
 }
+
+TEST(ReaderTest, MappedMatchesBuffered) {
+    for (int i = 0; i < 12; ++i) {
+        std::ostringstream path;
+        path << "test_data/test" << std::setfill('0') << std::setw(2) << i
+             << ".qc";
+        reader buffered { path.str(), read_mode::buffered, 16 };
+        reader mapped { path.str(), read_mode::mapped };
+        token expected, t;
+        do {
+            buffered.next_token(expected);
+            mapped.next_token(t);
+            EXPECT_EQ(t.kind, expected.kind);
+            EXPECT_EQ(t.word, expected.word);
+            EXPECT_EQ(t.line, expected.line);
+            EXPECT_EQ(t.column, expected.column);
+            EXPECT_EQ(t.file_offset, expected.file_offset);
+        } while (expected.kind != token_kind::eof);
+    }
+}
+
+TEST(ReaderTest, ReadaheadMatchesBuffered) {
+    for (int i = 0; i < 12; ++i) {
+        std::ostringstream path;
+        path << "test_data/test" << std::setfill('0') << std::setw(2) << i
+             << ".qc";
+        for (const std::streamsize buffer_size : { 1, 7, 4096 }) {
+            reader buffered { path.str(), read_mode::buffered, buffer_size };
+            reader ahead { path.str(), read_mode::readahead, buffer_size };
+            token expected, t;
+            do {
+                buffered.next_token(expected);
+                ahead.next_token(t);
+                EXPECT_EQ(t.kind, expected.kind);
+                EXPECT_EQ(t.word, expected.word);
+                EXPECT_EQ(t.line, expected.line);
+                EXPECT_EQ(t.column, expected.column);
+                EXPECT_EQ(t.file_offset, expected.file_offset);
+            } while (expected.kind != token_kind::eof);
+            EXPECT_NO_THROW(ahead.interrupt());
+        }
+    }
+}
+
+TEST(ReaderTest, ReadaheadJumpsBackAfterEof) {
+    const auto path
+        = std::filesystem::temp_directory_path() / "qpiler_readahead.qc";
+    for (const std::string text : { "abc def gh", "\xc3\x97" }) {
+        {
+            std::ofstream ofs(path, std::ios::binary);
+            ofs << text;
+        }
+        for (const std::streamsize buffer_size : { 2, 4 }) {
+            SCOPED_TRACE(buffer_size);
+            reader buffered { path, read_mode::buffered, buffer_size };
+            reader ahead { path, read_mode::readahead, buffer_size };
+            std::vector<token> tokens;
+            token t;
+            do {
+                buffered.next_token(tokens.emplace_back());
+                ahead.next_token(t);
+                EXPECT_EQ(t.word, tokens.back().word);
+            } while (t.kind != token_kind::eof);
+            // the last window must survive the fetch that found the end
+            const auto& last = tokens[tokens.size() - 2];
+            ahead.jump_to_position(last.file_offset, last.line, last.column);
+            ahead.next_token(t);
+            EXPECT_EQ(t.kind, last.kind);
+            EXPECT_EQ(t.word, last.word);
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ReaderTest, MappedJumpToPosition) {
+    reader r { "test_data/test04.qc", read_mode::mapped };
+    token first, t;
+    r.next_token(first);
+    while (t.kind != token_kind::eof) {
+        r.next_token(t);
+    }
+    EXPECT_NO_THROW(r.interrupt());
+    r.jump_to_position(first.file_offset, first.line, first.column);
+    r.next_token(t);
+    EXPECT_EQ(t.kind, first.kind);
+    EXPECT_EQ(t.word, first.word);
+    EXPECT_EQ(t.file_offset, first.file_offset);
+    EXPECT_THROW(r.jump_to_position(1 << 30, 0, 0), std::runtime_error);
+}
+
+TEST(ReaderTest, CachedJumpToPosition) {
+    auto cache = std::make_shared<block_cache_source>(
+        std::make_shared<file_source>("test_data/test04.qc", 16), 256, 32
+    );
+    reader r { cache };
+    std::vector<token> tokens;
+    do {
+        tokens.emplace_back();
+        r.next_token(tokens.back());
+    } while (tokens.back().kind != token_kind::eof);
+    const auto misses = cache->stats().misses;
+    for (size_t i = 0; i + 1 < tokens.size(); i += 3) {
+        const auto& expected = tokens[i];
+        token t;
+        r.jump_to_position(
+            expected.file_offset, expected.line, expected.column
+        );
+        r.next_token(t);
+        EXPECT_EQ(t.kind, expected.kind);
+        EXPECT_EQ(t.word, expected.word);
+        EXPECT_EQ(t.line, expected.line);
+    }
+    // the file fits in the cache, so re-reads never touch it again
+    EXPECT_EQ(cache->stats().misses, misses);
+    EXPECT_GT(cache->stats().hits, 0u);
+}
+
+TEST(ReaderTest, StreamMatchesBuffered) {
+    for (int i = 0; i < 12; ++i) {
+        std::ostringstream path;
+        path << "test_data/test" << std::setfill('0') << std::setw(2) << i
+             << ".qc";
+        std::ifstream ifs(path.str(), std::ios::binary);
+        std::istringstream in(
+            std::string(std::istreambuf_iterator<char>(ifs), {})
+        );
+        reader expected_reader { path.str(), 16 };
+        reader r { std::make_shared<stream_source>(in, 16) };
+        token expected, t;
+        do {
+            expected_reader.next_token(expected);
+            r.next_token(t);
+            EXPECT_EQ(t.kind, expected.kind);
+            EXPECT_EQ(t.word, expected.word);
+            EXPECT_EQ(t.line, expected.line);
+            EXPECT_EQ(t.file_offset, expected.file_offset);
+        } while (expected.kind != token_kind::eof);
+        EXPECT_NO_THROW(r.interrupt());
+    }
+}
+
+TEST(ReaderTest, KeywordSubKindsAndSymbols) {
+    std::string str = "while x: if y: return x; elif goto_ else break";
+    symbol_table table;
+    reader r { str };
+    r.intern_symbols(&table);
+    std::vector<token_view> keywords;
+    token_view t;
+    do {
+        r.next_token(t);
+        if (t.kind == token_kind::keyword) {
+            keywords.push_back(t);
+        }
+    } while (t.kind != token_kind::eof);
+    const std::vector<keyword_kind> expected {
+        keyword_kind::while_kw,  keyword_kind::identifier,
+        keyword_kind::if_kw,     keyword_kind::identifier,
+        keyword_kind::return_kw, keyword_kind::identifier,
+        keyword_kind::elif_kw,   keyword_kind::identifier,
+        keyword_kind::else_kw,   keyword_kind::break_kw
+    };
+    ASSERT_EQ(keywords.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(keywords[i].keyword, expected[i]);
+        EXPECT_EQ(table.name(keywords[i].symbol), keywords[i].word);
+    }
+    EXPECT_EQ(keywords[1].symbol, keywords[5].symbol);
+    EXPECT_NE(keywords[1].symbol, keywords[3].symbol);
+    EXPECT_EQ(
+        keywords[0].symbol,
+        static_cast<std::uint32_t>(keyword_kind::while_kw) - 1
+    );
+    EXPECT_EQ(t.symbol, no_symbol);
+}
+
+TEST(ReaderTest, OperatorsMunchLongestMatch) {
+    const std::string text = "a<<=b!=c->d/=e//x\n&&|||@#/**/++-";
+    const std::vector<std::string> expected { "a", "<<=", "b",  "!=", "c",
+                                              "->", "d",   "/=", "e",  "&&",
+                                              "||", "|",   "@",  "#",  "++",
+                                              "-" };
+    const auto path
+        = std::filesystem::temp_directory_path() / "qpiler_operators.qc";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text;
+    }
+    for (const std::streamsize buffer_size : { 1, 2, 3, 4096 }) {
+        reader r { path, read_mode::buffered, buffer_size, buffer_size };
+        std::vector<std::string> words;
+        token t;
+        for (r.next_token(t); t.kind != token_kind::eof; r.next_token(t)) {
+            if (t.kind != token_kind::comment) {
+                words.push_back(t.word);
+            }
+        }
+        EXPECT_EQ(words, expected) << buffer_size;
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ReaderTest, Utf8Identifiers) {
+    // größe = naïve·2 “ok” пер_1 変数
+    const std::string text = "gr\xc3\xb6\xc3\x9f"
+                             "e = na\xc3\xafve\xc2\xb7"
+                             "2 \xe2\x80\x9cok\xe2\x80\x9d "
+                             "\xd0\xbf\xd0\xb5\xd1\x80_1 "
+                             "\xe5\xa4\x89\xe6\x95\xb0";
+    const std::vector<std::string> keywords {
+        "gr\xc3\xb6\xc3\x9f"
+        "e",
+        "na\xc3\xafve", "ok", "\xd0\xbf\xd0\xb5\xd1\x80_1",
+        "\xe5\xa4\x89\xe6\x95\xb0"
+    };
+    const std::vector<std::string> others {
+        "=", "\xc2\xb7", "2", "\xe2\x80\x9c", "\xe2\x80\x9d"
+    };
+    const auto path
+        = std::filesystem::temp_directory_path() / "qpiler_utf8.qc";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text;
+    }
+    for (const std::streamsize buffer_size : { 1, 2, 3, 4096 }) {
+        reader r { path, read_mode::buffered, buffer_size, buffer_size };
+        std::vector<std::string> got_keywords, got_others;
+        token t;
+        for (r.next_token(t); t.kind != token_kind::eof; r.next_token(t)) {
+            if (t.kind == token_kind::keyword) {
+                got_keywords.push_back(t.word);
+            } else if (t.kind != token_kind::whitespace) {
+                got_others.push_back(t.word);
+            }
+        }
+        EXPECT_EQ(got_keywords, keywords) << buffer_size;
+        EXPECT_EQ(got_others, others) << buffer_size;
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ReaderTest, Utf8NonIdentifiers) {
+    // BOM 変数　＝　値； a×b÷ｃ ＡＢ１
+    const std::string text = "\xef\xbb\xbf"
+                             "\xe5\xa4\x89\xe6\x95\xb0\xe3\x80\x80"
+                             "\xef\xbc\x9d\xe3\x80\x80\xe5\x80\xa4"
+                             "\xef\xbc\x9b a\xc3\x97"
+                             "b\xc3\xb7\xef\xbd\x83 "
+                             "\xef\xbc\xa1\xef\xbc\xa2\xef\xbc\x91";
+    const std::vector<std::string> keywords {
+        "\xe5\xa4\x89\xe6\x95\xb0", "\xe5\x80\xa4", "a", "b",
+        "\xef\xbd\x83", "\xef\xbc\xa1\xef\xbc\xa2\xef\xbc\x91"
+    };
+    const std::vector<std::string> others {
+        "\xe3\x80\x80", "\xef\xbc\x9d", "\xe3\x80\x80", "\xef\xbc\x9b",
+        "\xc3\x97",     "\xc3\xb7"
+    };
+    const auto path
+        = std::filesystem::temp_directory_path() / "qpiler_utf8_other.qc";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text;
+    }
+    for (const std::streamsize buffer_size : { 1, 2, 3, 4, 5, 4096 }) {
+        reader r { path, read_mode::buffered, buffer_size, buffer_size };
+        std::vector<std::string> got_keywords, got_others;
+        token t;
+        r.next_token(t);
+        // the byte order mark is skipped as whitespace
+        EXPECT_EQ(t.kind, token_kind::whitespace) << buffer_size;
+        EXPECT_EQ(t.word, byte_order_mark) << buffer_size;
+        for (r.next_token(t); t.kind != token_kind::eof; r.next_token(t)) {
+            if (t.kind == token_kind::keyword) {
+                got_keywords.push_back(t.word);
+            } else if (t.kind != token_kind::whitespace) {
+                got_others.push_back(t.word);
+            }
+        }
+        EXPECT_EQ(got_keywords, keywords) << buffer_size;
+        EXPECT_EQ(got_others, others) << buffer_size;
+    }
+    std::filesystem::remove(path);
+    // only a leading one is skipped
+    reader r { std::make_shared<view_source>("a\xef\xbb\xbf") };
+    token t;
+    r.next_token(t);
+    r.next_token(t);
+    EXPECT_EQ(t.kind, token_kind::special_character);
+}
+
+TEST(ReaderTest, Utf8CheckedAfterJumps) {
+    std::string text = "x" + std::string(20, ' ') + "\"";
+    for (int i = 0; i < 20; ++i) {
+        text += "\xc3\xa9";
+    }
+    text += "\" y";
+    const auto path
+        = std::filesystem::temp_directory_path() / "qpiler_utf8_jump.qc";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text;
+    }
+    for (const std::streamsize buffer_size : { 1, 2, 5, 4096 }) {
+        SCOPED_TRACE(buffer_size);
+        reader r { path, read_mode::buffered, buffer_size, buffer_size };
+        // sequences split between the windows after a jump are still whole
+        r.jump_to_position(21, 0, 21);
+        token t;
+        ASSERT_NO_THROW(r.next_token(t));
+        EXPECT_EQ(t.kind, token_kind::string);
+        EXPECT_EQ(t.word, text.substr(22, 40));
+        // and a jump back checks the bytes it skipped over
+        r.jump_to_position(0, 0, 0);
+        do {
+            ASSERT_NO_THROW(r.next_token(t));
+        } while (t.kind != token_kind::eof);
+    }
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text.substr(0, 30) << '\xff' << text.substr(31);
+    }
+    for (const std::streamsize buffer_size : { 1, 5, 4096 }) {
+        reader r { path, read_mode::buffered, buffer_size, buffer_size };
+        r.jump_to_position(21, 0, 21);
+        token t;
+        EXPECT_THROW(r.next_token(t), std::runtime_error) << buffer_size;
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ReaderTest, InvalidUtf8Throws) {
+    const std::string text = "alpha \"b\xc3\x28\" gamma";
+    const auto path
+        = std::filesystem::temp_directory_path() / "qpiler_bad_utf8.qc";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text;
+    }
+    for (const std::streamsize buffer_size : { 1, 4, 4096 }) {
+        reader r { path, read_mode::buffered, buffer_size, buffer_size };
+        token t;
+        r.next_token(t);
+        EXPECT_EQ(t.word, "alpha");
+        r.next_token(t);
+        // the string holding the bad byte is the token that fails
+        EXPECT_THROW(r.next_token(t), std::runtime_error) << buffer_size;
+    }
+    for (std::string cut :
+         { std::string("ok \xe4\xb8"), std::string("\xff") }) {
+        reader r { cut };
+        token t;
+        EXPECT_THROW(
+            while (t.kind != token_kind::eof) { r.next_token(t); },
+            std::runtime_error
+        );
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ReaderTest, CheckpointRestore) {
+    for (const std::streamsize size : { 8, 16, 4096 }) {
+        auto cache = std::make_shared<block_cache_source>(
+            std::make_shared<file_source>("test_data/test04.qc", size), 256,
+            static_cast<size_t>(size)
+        );
+        reader r { cache };
+        token t;
+        r.next_token(t);
+        r.next_token(t);
+        const auto point = r.save();
+        std::vector<token> expected;
+        do {
+            expected.emplace_back();
+            r.next_token(expected.back());
+        } while (expected.back().kind != token_kind::eof);
+        const auto fetches = cache->stats().hits + cache->stats().misses;
+        r.restore(point);
+        if (size == 4096) {
+            // the whole file is one window: restoring does no I/O
+            EXPECT_EQ(cache->stats().hits + cache->stats().misses, fetches);
+        }
+        for (const auto& e : expected) {
+            r.next_token(t);
+            EXPECT_EQ(t.kind, e.kind);
+            EXPECT_EQ(t.word, e.word);
+            EXPECT_EQ(t.line, e.line);
+            EXPECT_EQ(t.column, e.column);
+            EXPECT_EQ(t.file_offset, e.file_offset);
+        }
+    }
+}
+
+TEST(ReaderTest, TokenViewSpans) {
+    std::string str = R"(alpha 42 "plain" "esc\tape" // note)";
+    reader r { str };
+    const auto anchor = r.keep_alive();
+    ASSERT_NE(anchor, nullptr);
+    token_view t;
+    std::vector<token_view> tokens;
+    do {
+        r.next_token(t);
+        tokens.push_back(t);
+    } while (t.kind != token_kind::eof);
+    ASSERT_EQ(tokens.size(), 10u);
+    EXPECT_EQ(tokens[0].word, "alpha");
+    EXPECT_FALSE(tokens[0].owns());
+    EXPECT_EQ(tokens[2].word, "42");
+    EXPECT_EQ(tokens[4].kind, token_kind::string);
+    EXPECT_EQ(tokens[4].word, "plain");
+    EXPECT_FALSE(tokens[4].owns());
+    EXPECT_EQ(tokens[6].word, "esc\tape");
+    EXPECT_TRUE(tokens[6].owns());
+    EXPECT_EQ(tokens[8].word, "// note");
+    EXPECT_EQ(tokens[9].kind, token_kind::eof);
+
+    token_view moved = std::move(tokens[6]);
+    EXPECT_EQ(moved.word, "esc\tape");
+    EXPECT_TRUE(moved.owns());
+}
+
+TEST(ReaderTest, TokenViewMatchesToken) {
+    for (int i = 0; i < 12; ++i) {
+        std::ostringstream path;
+        path << "test_data/test" << std::setfill('0') << std::setw(2) << i
+             << ".qc";
+        for (const auto mode : { read_mode::buffered, read_mode::mapped }) {
+            reader owning { path.str(), read_mode::buffered, 16 };
+            reader viewing { path.str(), mode, 16 };
+            EXPECT_EQ(
+                viewing.keep_alive() == nullptr, mode != read_mode::mapped
+            );
+            token expected;
+            token_view t;
+            do {
+                owning.next_token(expected);
+                viewing.next_token(t);
+                EXPECT_EQ(t.kind, expected.kind);
+                EXPECT_EQ(t.word, expected.word);
+                EXPECT_EQ(t.line, expected.line);
+                EXPECT_EQ(t.column, expected.column);
+                EXPECT_EQ(t.file_offset, expected.file_offset);
+            } while (expected.kind != token_kind::eof);
+        }
+    }
+}
+
+TEST(ReaderTest, ColumnAfterMultilineComment) {
+    std::string str = "/* one\n two */x";
+    reader r { str };
+    token t;
+    r.next_token(t);
+    EXPECT_EQ(t.kind, token_kind::comment);
+    r.next_token(t);
+    EXPECT_EQ(t.kind, token_kind::keyword);
+    EXPECT_EQ(t.line, 1);
+    EXPECT_EQ(t.column, 7);
+}
+
+TEST(ReaderTest, LineAfterMultilineString) {
+    std::string str = "'one\ntwo' \"\\u00e9\\n\n\"x";
+    reader r { str };
+    token t;
+    r.next_token(t);
+    EXPECT_EQ(t.kind, token_kind::string);
+    EXPECT_EQ(t.word, "one\ntwo");
+    r.next_token(t);
+    r.next_token(t);
+    EXPECT_EQ(t.word, "\u00e9\n\n");
+    EXPECT_EQ(t.line, 1);
+    EXPECT_EQ(t.column, 5);
+    r.next_token(t);
+    EXPECT_EQ(t.kind, token_kind::keyword);
+    EXPECT_EQ(t.line, 2);
+    EXPECT_EQ(t.column, 1);
+}
+
+TEST(ReaderTest, SkipCommentText) {
+    const std::string text = "a /* " + std::string(500, '*') + "\n*/ b // "
+        + std::string(300, '/') + "\nc";
+    const auto path = std::filesystem::temp_directory_path()
+        / "qpiler_skip_comments.qc";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text;
+    }
+    for (const std::streamsize buffer_size : { 1, 64, 4096 }) {
+        std::string copy = text;
+        reader expected { copy };
+        reader r { path, buffer_size };
+        token want;
+        token_view t;
+        do {
+            expected.next_token(want);
+            r.next_token(t, comment_text::skip);
+            EXPECT_EQ(t.kind, want.kind);
+            EXPECT_EQ(
+                t.word,
+                want.kind == token_kind::comment ? std::string() : want.word
+            );
+            EXPECT_EQ(t.line, want.line);
+            EXPECT_EQ(t.column, want.column);
+        } while (want.kind != token_kind::eof);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ReaderTest, SignificantTokensRecordTrivia) {
+    std::ifstream ifs(
+        std::filesystem::path("test_data") / "test05.qc", std::ios::binary
+    );
+    const std::string text = "  /* a */ // b\n" + std::string(
+        std::istreambuf_iterator<char>(ifs), {}
+    ) + " x/y /**/";
+    const auto path = std::filesystem::temp_directory_path()
+        / "qpiler_significant.qc";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text;
+    }
+    for (const std::streamsize buffer_size : { 1, 7, 4096 }) {
+        std::string copy = text;
+        reader expected { copy };
+        reader r { path, buffer_size };
+        std::vector<trivia_span> trivia;
+        std::vector<token> skipped;
+        token want;
+        token_view t;
+        do {
+            expected.next_token(want);
+            if (want.kind == token_kind::whitespace
+                || want.kind == token_kind::comment) {
+                skipped.push_back(want);
+                continue;
+            }
+            r.next_significant_token(t, &trivia);
+            EXPECT_EQ(t.kind, want.kind);
+            EXPECT_EQ(t.word, want.word);
+            EXPECT_EQ(t.line, want.line);
+            EXPECT_EQ(t.column, want.column);
+            EXPECT_EQ(t.file_offset, want.file_offset);
+        } while (want.kind != token_kind::eof);
+        ASSERT_EQ(trivia.size(), skipped.size());
+        for (size_t i = 0; i < trivia.size(); ++i) {
+            EXPECT_EQ(trivia[i].kind, skipped[i].kind);
+            EXPECT_EQ(trivia[i].file_offset, skipped[i].file_offset);
+            EXPECT_EQ(
+                trivia[i].length,
+                static_cast<std::streamoff>(skipped[i].word.size())
+            );
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ReaderTest, BatchMatchesTokens) {
+    std::string text;
+    for (int i = 0; i < 12; ++i) {
+        std::ostringstream path;
+        path << "test_data/test" << std::setfill('0') << std::setw(2) << i
+             << ".qc";
+        std::ifstream ifs(path.str(), std::ios::binary);
+        text.append(std::istreambuf_iterator<char>(ifs), {});
+    }
+    std::string copy = text;
+    reader expected { copy };
+    std::string data = text;
+    reader r { data };
+    token_batch batch;
+    token want;
+    do {
+        EXPECT_GT(r.next_tokens(batch, 5), 0u);
+        EXPECT_LE(batch.size(), 5u);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            expected.next_token(want);
+            EXPECT_EQ(batch.kinds[i], want.kind);
+            EXPECT_EQ(batch.offsets[i], want.file_offset);
+            EXPECT_EQ(batch.lines[i], want.line);
+            EXPECT_EQ(batch.columns[i], want.column);
+            if (want.kind != token_kind::string) {
+                EXPECT_EQ(batch.text(i, text), want.word);
+            }
+        }
+    } while (batch.kinds.back() != token_kind::eof);
+}
+
+TEST(ReaderTest, OffsetModeLocatesTokens) {
+    const std::string text = "a /* x\ny */ 'multi\nline'\n\n  b // c\nd(1.5)";
+    const auto path = std::filesystem::temp_directory_path()
+        / "qpiler_offsets.qc";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text;
+    }
+    for (const std::streamsize buffer_size : { 1, 7, 4096 }) {
+        std::string copy = text;
+        reader expected { copy };
+        reader r { path, buffer_size };
+        r.set_position_mode(position_mode::offsets);
+        token want, t;
+        do {
+            expected.next_token(want);
+            r.next_token(t);
+            EXPECT_EQ(t.kind, want.kind);
+            EXPECT_EQ(t.line, -1);
+            EXPECT_EQ(t.column, -1);
+            const auto at = r.locate(t.file_offset);
+            EXPECT_EQ(at.line, want.line);
+            EXPECT_EQ(at.column, want.column);
+            std::ostringstream dumped, tracked;
+            t.dump(dumped, r.lines());
+            want.dump(tracked);
+            EXPECT_EQ(dumped.str(), tracked.str());
+        } while (want.kind != token_kind::eof);
+        EXPECT_THROW(
+            r.set_position_mode(position_mode::tracked), std::logic_error
+        );
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ReaderTest, LongTokensAcrossReloads) {
+    const std::string text = std::string(1024, '9') + " "
+        + std::string(512, '9') + "." + std::string(511, '9') + "e+12 /*"
+        + std::string(700, '*') + "\n" + std::string(300, 'x') + "*/ \""
+        + std::string(400, 'a') + R"(\nA\"\\)" + std::string(200, 'b')
+        + "\" " + std::string(600, '_') + " // " + std::string(900, '/');
+    const auto path = std::filesystem::temp_directory_path()
+        / "qpiler_long_tokens.qc";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text;
+    }
+    for (const std::streamsize buffer_size : { 1, 7, 64, 4096 }) {
+        std::string copy = text;
+        reader expected { copy };
+        reader r { path, buffer_size };
+        token want, t;
+        do {
+            expected.next_token(want);
+            r.next_token(t);
+            EXPECT_EQ(t.kind, want.kind);
+            EXPECT_EQ(t.word, want.word);
+            EXPECT_EQ(t.line, want.line);
+            EXPECT_EQ(t.column, want.column);
+            EXPECT_EQ(t.file_offset, want.file_offset);
+        } while (want.kind != token_kind::eof);
+    }
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,218 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "relexer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iomanip>
+#include <random>
+
+#include "reader.hpp"
+
+static std::vector<token>
+lex_full(const std::string& text, symbol_table* symbols = nullptr) {
+    std::string data = text;
+    reader r { data };
+    r.intern_symbols(symbols);
+    std::vector<token> tokens;
+    do {
+        r.next_token(tokens.emplace_back());
+    } while (tokens.back().kind != token_kind::eof);
+    return tokens;
+}
+
+static std::string
+apply_edit(const std::string& text, const text_edit& edit, const char* with) {
+    return text.substr(0, static_cast<size_t>(edit.offset)) + with
+        + text.substr(static_cast<size_t>(edit.offset + edit.removed));
+}
+
+static void expect_same_tokens(
+    const std::vector<token>& got, const std::vector<token>& want
+) {
+    ASSERT_EQ(got.size(), want.size());
+    for (size_t i = 0; i < want.size(); ++i) {
+        EXPECT_EQ(got[i].kind, want[i].kind) << "token " << i;
+        EXPECT_EQ(got[i].word, want[i].word) << "token " << i;
+        EXPECT_EQ(got[i].line, want[i].line) << "token " << i;
+        EXPECT_EQ(got[i].column, want[i].column) << "token " << i;
+        EXPECT_EQ(got[i].file_offset, want[i].file_offset) << "token " << i;
+        EXPECT_EQ(got[i].keyword, want[i].keyword) << "token " << i;
+        EXPECT_EQ(got[i].symbol, want[i].symbol) << "token " << i;
+        EXPECT_EQ(got[i].value.index(), want[i].value.index()) << "token " << i;
+    }
+}
+
+TEST(RelexerTest, SingleEdits) {
+    const std::string text
+        = "x = 12;\nif (x > 1) { y = \"s\"; } // done\nz = x+y;\n";
+    const auto before = lex_full(text);
+    const struct {
+        text_edit edit;
+        const char* with;
+    } cases[] = {
+        { { 0, 0, 1 }, "w" }, // joins the first identifier
+        { { 4, 2, 3 }, "345" }, // replaces a literal
+        { { 6, 0, 1 }, "\n" }, // shifts every later line
+        { { 14, 1, 2 }, ">=" }, // grows an operator
+        { { 17, 0, 2 }, "/*" }, // opens a comment that never closes
+        { { 21, 0, 1 }, "\"" }, // unbalances the quotes
+        { { 26, 1, 3 }, "\\\"x" }, // escapes a quote inside the string
+        { { 32, 8, 0 }, "" }, // removes the comment and its line break
+        { { 43, 1, 1 }, "=" }, // glues onto the operator before it
+        { { static_cast<std::streamoff>(text.size()), 0, 3 }, "end" },
+    };
+    for (const auto& [edit, with] : cases) {
+        SCOPED_TRACE(with);
+        const auto after = apply_edit(text, edit, with);
+        bool unterminated = false;
+        std::vector<token> want;
+        try {
+            want = lex_full(after);
+        } catch (const std::runtime_error&) {
+            unterminated = true;
+        }
+        if (unterminated) {
+            EXPECT_THROW(
+                static_cast<void>(relex(after, before, { edit })),
+                std::runtime_error
+            );
+        } else {
+            expect_same_tokens(relex(after, before, { edit }), want);
+        }
+    }
+}
+
+TEST(RelexerTest, SeveralEditsAtOnce) {
+    const std::string text = "a = 1;\nb = 2;\nc = 3;\nd = 4;\n";
+    const std::string after = "a = 1;\nbb = 2;\nc = 3 + 30;\n";
+    // given out of order: the tail removal, the widened sum, the longer name
+    const std::vector<text_edit> edits
+        = { { 21, 7, 0 }, { 19, 0, 5 }, { 7, 0, 1 } };
+    symbol_table symbols;
+    const auto before = lex_full(text, &symbols);
+    expect_same_tokens(
+        relex(after, before, edits, &symbols), lex_full(after, &symbols)
+    );
+}
+
+TEST(RelexerTest, EditsInsideTheCodePointAfterAnIdentifier) {
+    // abc× becomes abcÀ, joining the identifier, and back; then the same
+    // with the edit one and two tokens further on
+    const struct {
+        std::string text;
+        text_edit edit;
+        const char* with;
+    } cases[] = {
+        { "abc\xc3\x97", { 4, 1, 1 }, "\x80" },
+        { "abc\xc3\x80", { 4, 1, 1 }, "\x97" },
+        { "x abc\xe3\x80\x80 y", { 7, 1, 1 }, "\x85" },
+        { "abc\xef\xbc\x9d", { 5, 1, 1 }, "\xa1" },
+        { "ab \xef\xbc\xa1", { 3, 1, 1 }, "\xe3" },
+    };
+    for (const auto& [text, edit, with] : cases) {
+        SCOPED_TRACE(text);
+        const auto after = apply_edit(text, edit, with);
+        expect_same_tokens(
+            relex(after, lex_full(text), { edit }), lex_full(after)
+        );
+    }
+}
+
+TEST(RelexerTest, ReusedTokensTakeTheNewTable) {
+    const std::string text = "alpha = beta;\ngamma = alpha + 1;\n";
+    const std::string after = "alpha = beta;\ngamma = alpha + 2;\n";
+    const std::vector<text_edit> edits = { { 31, 1, 1 } };
+    symbol_table old_symbols;
+    old_symbols.intern("unrelated");
+    const auto before = lex_full(text, &old_symbols);
+    symbol_table symbols;
+    expect_same_tokens(
+        relex(after, before, edits, &symbols), lex_full(after, &symbols)
+    );
+    expect_same_tokens(relex(after, before, edits), lex_full(after));
+}
+
+TEST(RelexerTest, RandomEditsMatchFullPass) {
+    std::string text;
+    for (int i = 0; i < 12; ++i) {
+        std::ostringstream path;
+        path << "test_data/test" << std::setfill('0') << std::setw(2) << i
+             << ".qc";
+        std::ifstream ifs(path.str(), std::ios::binary);
+        text.append(std::istreambuf_iterator<char>(ifs), {});
+    }
+    const char* const pieces[] = { "",  " ",  "\n", "x",  "1",  "0.5", "\"",
+                                   "'", "/*", "*/", "//", "=",  "<<=", "é",
+                                   "{", "}",  "if", "_a", "+-", "e+" };
+    std::mt19937 random { 7 };
+    auto tokens = lex_full(text);
+    size_t checked = 0;
+    for (int round = 0; round < 400; ++round) {
+        const auto size = text.size();
+        const auto offset = std::uniform_int_distribution<size_t> { 0, size }(
+            random
+        );
+        const auto removed = std::uniform_int_distribution<size_t> {
+            0, std::min<size_t>(4, size - offset)
+        }(random);
+        const char* with = pieces[random() % std::size(pieces)];
+        const text_edit edit { static_cast<std::streamoff>(offset),
+                               static_cast<std::streamoff>(removed),
+                               static_cast<std::streamoff>(
+                                   std::char_traits<char>::length(with)
+                               ) };
+        const auto after = apply_edit(text, edit, with);
+        std::vector<token> want;
+        try {
+            want = lex_full(after);
+        } catch (const std::runtime_error&) {
+            continue; // the edit broke the text; keep the old one
+        }
+        SCOPED_TRACE(round);
+        tokens = relex(after, std::move(tokens), { edit });
+        expect_same_tokens(tokens, want);
+        text = after;
+        ++checked;
+    }
+    EXPECT_GT(checked, 100U);
+}
+
+TEST(RelexerTest, RejectsMismatchedEdits) {
+    const std::string text = "a = 1;";
+    const auto before = lex_full(text);
+    EXPECT_THROW(
+        static_cast<void>(relex("a = 12;", before, { { 4, 1, 1 } })),
+        std::invalid_argument
+    );
+    EXPECT_THROW(
+        static_cast<void>(relex("a", before, { { 0, 3, 0 }, { 2, 3, 0 } })),
+        std::invalid_argument
+    );
+    EXPECT_THROW(
+        static_cast<void>(relex("a = 1;", {}, {})), std::invalid_argument
+    );
+}
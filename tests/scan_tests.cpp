@@ -0,0 +1,113 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "scan.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "char_class.hpp"
+
+static size_t scalar_span(const std::string_view text, bool (*match)(char)) {
+    return static_cast<size_t>(
+        std::find_if_not(text.begin(), text.end(), match) - text.begin()
+    );
+}
+
+TEST(ScanTest, MatchesScalar) {
+    std::mt19937 rng { 42 };
+    const std::string alphabet
+        = " \t\n\v\f\r_azAZ09@[`{/\"'\\\x80\xbf\xc0\xc2\xc3\xe2\xf4\xf5\xff";
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    for (size_t length = 0; length < 130; ++length) {
+        for (int round = 0; round < 20; ++round) {
+            std::string text(length, ' ');
+            // long homogeneous prefixes exercise the vector loops
+            const auto prefix = std::uniform_int_distribution<size_t>(
+                0, length
+            )(rng);
+            const char fill = alphabet[pick(rng)];
+            for (size_t i = 0; i < length; ++i) {
+                text[i] = i < prefix ? fill : alphabet[pick(rng)];
+            }
+            EXPECT_EQ(span_whitespace(text), scalar_span(text, is_space));
+            EXPECT_EQ(
+                span_identifier(text), scalar_span(text, is_identifier)
+            );
+            EXPECT_EQ(span_digits(text), scalar_span(text, is_digit));
+            for (const char quote : { '"', '\'' }) {
+                const auto stop
+                    = text.find_first_of(std::string { quote, '\\', '\n' });
+                EXPECT_EQ(
+                    span_string_body(text, quote),
+                    stop == std::string::npos ? text.size() : stop
+                );
+            }
+            EXPECT_EQ(
+                count_newlines(text),
+                static_cast<size_t>(std::count(text.begin(), text.end(), '\n'))
+            );
+        }
+    }
+}
+
+TEST(ScanTest, ValidatesUtf8) {
+    const auto check = [](const std::string_view text) {
+        utf8_validator v;
+        return v.feed(text);
+    };
+    constexpr auto ok = std::string_view::npos;
+    EXPECT_EQ(check(std::string(100, 'a')), ok);
+    EXPECT_EQ(check("caf\xc3\xa9 \xe4\xb8\xad\xf0\x9f\x98\x80"), ok);
+    EXPECT_EQ(check(std::string(40, 'a') + "\xff"), 40u);
+    EXPECT_EQ(check("a\x80"), 1u); // stray continuation
+    EXPECT_EQ(check("\xc0\xaf"), 0u); // overlong
+    EXPECT_EQ(check("ab\xe0\x80\xaf"), 2u); // overlong
+    EXPECT_EQ(check("\xed\xa0\x80"), 0u); // surrogate
+    EXPECT_EQ(check("\xf4\x90\x80\x80"), 0u); // past U+10FFFF
+    EXPECT_EQ(check("\xc3("), 0u);
+
+    // a sequence cut by a window boundary, one byte at a time
+    const std::string text = "x\xf0\x9f\x98\x80y\xe4\xb8\xad";
+    utf8_validator v;
+    for (const char c : text) {
+        EXPECT_EQ(v.feed(std::string_view(&c, 1)), ok);
+    }
+    EXPECT_EQ(v.pending(), 0u);
+    EXPECT_EQ(v.feed("\xe4\xb8"), ok);
+    EXPECT_EQ(v.pending(), 2u);
+    EXPECT_EQ(v.feed("a"), 0u);
+}
+
+TEST(ScanTest, Runs) {
+    EXPECT_EQ(span_whitespace(std::string(100, ' ') + "x"), 100u);
+    EXPECT_EQ(span_identifier("snake_Case_42(x)"), 13u);
+    EXPECT_EQ(span_digits(std::string(1024, '9') + ".0"), 1024u);
+    EXPECT_EQ(span_digits(""), 0u);
+    EXPECT_EQ(span_string_body(std::string(40, 'a') + "\\\"", '"'), 40u);
+    EXPECT_EQ(span_string_body(std::string(40, '"') + "'", '\''), 40u);
+    EXPECT_EQ(count_newlines(std::string(64, '\n')), 64u);
+}
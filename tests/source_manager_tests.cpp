@@ -0,0 +1,108 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "source_manager.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+TEST(SourceManagerTest, LaysFilesOutBackToBack) {
+    source_manager sources;
+    const auto first = sources.add_buffer("first", "a\nbc");
+    const auto file = sources.add_file("test_data/test04.qc");
+    const auto last = sources.add_buffer("last", "x");
+    EXPECT_EQ(sources.file_count(), 3U);
+    EXPECT_EQ(sources.base(first), 0U);
+    EXPECT_EQ(sources.base(file), 5U);
+    EXPECT_EQ(
+        sources.base(last),
+        sources.base(file) + static_cast<global_offset>(sources.size(file)) + 1
+    );
+    EXPECT_EQ(sources.name(first), "first");
+    EXPECT_EQ(sources.name(file), "test_data/test04.qc");
+
+    // the eof position of a file still belongs to it
+    EXPECT_EQ(sources.file_of(4), first);
+    EXPECT_EQ(sources.file_of(5), file);
+    EXPECT_EQ(sources.file_of(sources.to_global(last, 1)), last);
+    EXPECT_THROW(
+        (void)sources.file_of(sources.to_global(last, 1) + 1),
+        std::out_of_range
+    );
+    EXPECT_THROW((void)sources.to_global(first, 5), std::out_of_range);
+}
+
+TEST(SourceManagerTest, LocatesTokensOfEveryFile) {
+    source_manager sources;
+    sources.add_buffer("inline", "x = 1;\n  y = \"a\nb\";\n");
+    for (int i = 0; i < 4; ++i) {
+        std::ostringstream path;
+        path << "test_data/test0" << i << ".qc";
+        sources.add_file(
+            path.str(), i % 2 == 0 ? read_mode::mapped : read_mode::buffered
+        );
+    }
+    for (file_id file = 0; file < sources.file_count(); ++file) {
+        reader r { sources.open(file) };
+        token t;
+        do {
+            r.next_token(t);
+            const auto at = sources.locate(
+                sources.to_global(file, t.file_offset)
+            );
+            EXPECT_EQ(at.file, file);
+            EXPECT_EQ(at.offset, t.file_offset);
+            EXPECT_EQ(at.position.line, t.line) << sources.name(file);
+            EXPECT_EQ(at.position.column, t.column) << sources.name(file);
+        } while (t.kind != token_kind::eof);
+    }
+}
+
+TEST(SourceManagerTest, SharesWhatCanBeShared) {
+    source_manager sources;
+    const auto mapped = sources.add_file("test_data/test01.qc");
+    EXPECT_EQ(sources.add_file("./test_data/test01.qc"), mapped);
+    EXPECT_EQ(sources.open(mapped), sources.open(mapped));
+    const auto buffered
+        = sources.add_file("test_data/test02.qc", read_mode::buffered);
+    EXPECT_NE(sources.open(buffered), sources.open(buffered));
+    EXPECT_EQ(sources.file_count(), 2U);
+}
+
+TEST(SourceManagerTest, RejectsWhatCannotBePlaced) {
+    source_manager sources;
+    std::istringstream in { "abc" };
+    EXPECT_THROW(
+        sources.add_source("stream", std::make_shared<stream_source>(in)),
+        std::invalid_argument
+    );
+    EXPECT_THROW(sources.add_source("null", nullptr), std::invalid_argument);
+    EXPECT_THROW(
+        sources.add_file("test_data/missing.qc", read_mode::buffered),
+        std::invalid_argument
+    );
+    EXPECT_THROW((void)sources.name(0), std::out_of_range);
+    EXPECT_EQ(sources.file_count(), 0U);
+}
@@ -0,0 +1,178 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "source.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+TEST(SourceTest, MemoryWindow) {
+    memory_source src { "hello world" };
+    EXPECT_EQ(src.fetch(0), "hello world");
+    EXPECT_EQ(src.fetch(6), "world");
+    EXPECT_TRUE(src.fetch(11).empty());
+    EXPECT_TRUE(src.fetch(42).empty());
+    EXPECT_EQ(src.size(), 11);
+    EXPECT_FALSE(src.is_open());
+}
+
+TEST(SourceTest, ViewWindow) {
+    const std::string data = "hello world";
+    view_source src { data };
+    EXPECT_EQ(src.fetch(6).data(), data.data() + 6);
+    EXPECT_TRUE(src.fetch(11).empty());
+    EXPECT_EQ(src.size(), 11);
+    EXPECT_TRUE(src.stable());
+}
+
+TEST(SourceTest, FileChunks) {
+    const std::filesystem::path path = "test_data/test04.qc";
+    std::ifstream ifs(path, std::ios::binary);
+    const std::string expected(std::istreambuf_iterator<char>(ifs), {});
+
+    file_source src { path, 7 };
+    EXPECT_EQ(src.size(), static_cast<std::streamoff>(expected.size()));
+    std::string got;
+    for (auto window = src.fetch(0); !window.empty();
+         window = src.fetch(static_cast<std::streamoff>(got.size()))) {
+        EXPECT_LE(window.size(), 7u);
+        got += window;
+    }
+    EXPECT_EQ(got, expected);
+    EXPECT_TRUE(src.eof());
+    EXPECT_EQ(src.fetch(3), expected.substr(3, 7));
+}
+
+TEST(SourceTest, ReadaheadChunks) {
+    const std::filesystem::path path = "test_data/test04.qc";
+    std::ifstream ifs(path, std::ios::binary);
+    const std::string expected(std::istreambuf_iterator<char>(ifs), {});
+
+    readahead_source src { std::make_shared<file_source>(path, 7) };
+    EXPECT_EQ(src.size(), static_cast<std::streamoff>(expected.size()));
+    EXPECT_TRUE(src.is_open());
+    std::string got;
+    for (auto window = src.fetch(0); !window.empty();
+         window = src.fetch(static_cast<std::streamoff>(got.size()))) {
+        EXPECT_LE(window.size(), 7u);
+        got += window;
+    }
+    EXPECT_EQ(got, expected);
+    EXPECT_TRUE(src.eof());
+    // a jump back, then sequential reads again
+    EXPECT_EQ(src.fetch(3), expected.substr(3, 7));
+    EXPECT_FALSE(src.eof());
+    EXPECT_EQ(src.fetch(10), expected.substr(10, 7));
+}
+
+TEST(SourceTest, StreamChunks) {
+    const std::filesystem::path path = "test_data/test04.qc";
+    std::ifstream ifs(path, std::ios::binary);
+    const std::string expected(std::istreambuf_iterator<char>(ifs), {});
+
+    std::istringstream in(expected);
+    stream_source src { in, 7, true };
+    EXPECT_EQ(src.size(), -1);
+    std::string got;
+    for (auto window = src.fetch(0); !window.empty();
+         window = src.fetch(static_cast<std::streamoff>(got.size()))) {
+        EXPECT_LE(window.size(), 7u);
+        got += window;
+    }
+    EXPECT_EQ(got, expected);
+    EXPECT_TRUE(src.eof());
+    // jumps back are replayed from the spill file
+    EXPECT_EQ(src.fetch(3), expected.substr(3, 7));
+    EXPECT_FALSE(src.eof());
+    EXPECT_EQ(src.fetch(110), expected.substr(110));
+}
+
+TEST(SourceTest, StreamWithoutSpill) {
+    const std::string data = "0123456789abcdefghij";
+    std::istringstream in(data);
+    stream_source src { in, 4, false };
+    EXPECT_EQ(src.fetch(0), "0123");
+    // jumping ahead skips the bytes in between
+    EXPECT_EQ(src.fetch(10), "ab");
+    EXPECT_EQ(src.fetch(12), "cdef");
+    EXPECT_THROW(src.fetch(2), std::runtime_error);
+    EXPECT_EQ(src.fetch(16), "ghij");
+    EXPECT_TRUE(src.fetch(20).empty());
+    EXPECT_TRUE(src.eof());
+}
+
+TEST(SourceTest, BlockCacheReusesBlocks) {
+    const std::filesystem::path path = "test_data/test04.qc";
+    std::ifstream ifs(path, std::ios::binary);
+    const std::string expected(std::istreambuf_iterator<char>(ifs), {});
+    ASSERT_GT(expected.size(), 24u);
+
+    // room for two 8-byte blocks, read 3 bytes at a time underneath
+    block_cache_source src { std::make_shared<file_source>(path, 3), 16, 8 };
+    EXPECT_EQ(src.size(), static_cast<std::streamoff>(expected.size()));
+    std::string got;
+    for (auto window = src.fetch(0); !window.empty();
+         window = src.fetch(static_cast<std::streamoff>(got.size()))) {
+        EXPECT_LE(window.size(), 8u);
+        got += window;
+    }
+    EXPECT_EQ(got, expected);
+    EXPECT_TRUE(src.eof());
+
+    const auto [hits, misses] = src.stats();
+    EXPECT_EQ(src.fetch(3), expected.substr(3, 5));
+    EXPECT_FALSE(src.eof());
+    EXPECT_EQ(src.fetch(5), expected.substr(5, 3));
+    EXPECT_EQ(src.fetch(10), expected.substr(10, 6));
+    EXPECT_EQ(src.stats().misses, misses + 2);
+    EXPECT_EQ(src.fetch(3), expected.substr(3, 5));
+    EXPECT_EQ(src.stats().misses, misses + 2);
+    // a third block evicts the least recently used one, [8, 16)
+    EXPECT_EQ(src.fetch(17), expected.substr(17, 7));
+    EXPECT_EQ(src.fetch(0), expected.substr(0, 8));
+    EXPECT_EQ(src.fetch(12), expected.substr(12, 4));
+    EXPECT_EQ(src.stats().misses, misses + 4);
+    EXPECT_EQ(src.stats().hits, hits + 3);
+}
+
+TEST(SourceTest, MappedFile) {
+    const std::filesystem::path path = "test_data/test04.qc";
+    std::ifstream ifs(path, std::ios::binary);
+    const std::string expected(std::istreambuf_iterator<char>(ifs), {});
+
+    mapped_source src { path };
+    EXPECT_EQ(src.fetch(0), expected);
+    EXPECT_EQ(src.fetch(5), expected.substr(5));
+    EXPECT_TRUE(src.fetch(src.size()).empty());
+    EXPECT_TRUE(src.is_open());
+}
+
+TEST(SourceTest, MissingFileThrows) {
+    EXPECT_THROW(file_source { "test_data/missing.qc" }, std::invalid_argument);
+    EXPECT_THROW(
+        mapped_source { "test_data/missing.qc" }, std::invalid_argument
+    );
+    EXPECT_THROW(block_cache_source { nullptr }, std::invalid_argument);
+}
@@ -0,0 +1,59 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "symbols.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(SymbolsTest, ClassifiesReservedWords) {
+    for (size_t i = 0; i < reserved_words.size(); ++i) {
+        EXPECT_EQ(
+            classify_keyword(reserved_words[i]),
+            static_cast<keyword_kind>(i + 1)
+        );
+    }
+    for (const std::string_view word :
+         { "i", "iff", "If", "elsif", "whiles", "fo", "retur", "continues",
+           "gotoo", "x", "catchy", "finally_", "go_to" }) {
+        EXPECT_EQ(classify_keyword(word), keyword_kind::identifier) << word;
+    }
+    static_assert(classify_keyword("elif") == keyword_kind::elif_kw);
+}
+
+TEST(SymbolsTest, InternsDenseIds) {
+    symbol_table table;
+    EXPECT_EQ(table.size(), reserved_words.size());
+    EXPECT_EQ(
+        table.intern("while"),
+        static_cast<std::uint32_t>(keyword_kind::while_kw) - 1
+    );
+    const auto alpha = table.intern("alpha");
+    const auto beta = table.intern("beta");
+    EXPECT_EQ(alpha, reserved_words.size());
+    EXPECT_EQ(beta, alpha + 1);
+    EXPECT_EQ(table.intern(std::string("alpha")), alpha);
+    EXPECT_EQ(table.name(beta), "beta");
+    EXPECT_EQ(table.size(), reserved_words.size() + 2);
+    EXPECT_THROW(static_cast<void>(table.name(1000)), std::out_of_range);
+}
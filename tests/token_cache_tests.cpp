@@ -0,0 +1,192 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "token_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <thread>
+
+#include "reader.hpp"
+
+static std::filesystem::path fresh_directory(const std::string& name) {
+    const auto directory = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(directory);
+    return directory;
+}
+
+static size_t entry_count(const std::filesystem::path& directory) {
+    size_t count = 0;
+    for (const auto& file : std::filesystem::directory_iterator(directory)) {
+        count += file.path().extension() == ".qtok" ? 1U : 0U;
+    }
+    return count;
+}
+
+static void expect_matches_reader(
+    const cached_tokens& cached, const std::string& text
+) {
+    std::string data = text;
+    reader r { data };
+    token t;
+    size_t i = 0;
+    do {
+        r.next_token(t);
+        ASSERT_LT(i, cached.size());
+        EXPECT_EQ(cached.kind(i), t.kind) << "token " << i;
+        EXPECT_EQ(cached.offset(i), t.file_offset) << "token " << i;
+        EXPECT_EQ(cached.keyword(i), t.keyword) << "token " << i;
+        if (const auto* big
+            = std::get_if<std::shared_ptr<const big_number>>(&t.value)) {
+            const auto value = cached.value(i);
+            const auto* got
+                = std::get_if<std::shared_ptr<const big_number>>(&value);
+            ASSERT_NE(got, nullptr) << "token " << i;
+            EXPECT_EQ(**got, **big) << "token " << i;
+        } else {
+            EXPECT_EQ(cached.value(i), t.value) << "token " << i;
+        }
+        ++i;
+    } while (t.kind != token_kind::eof);
+    EXPECT_EQ(cached.size(), i);
+}
+
+TEST(TokenCacheTest, StoresAndMapsBack) {
+    const auto directory = fresh_directory("qpiler_cache_roundtrip");
+    const std::string text
+        = "if (n >= 10) { x = 0.25e3; } // note\n"
+          "y = 123456789012345678901234567890 + 42;\n"
+          "s = \"a\\\"b\"; while x <<= 1;";
+    {
+        token_cache cache { directory };
+        const auto tokens = cache.tokens_of(text);
+        EXPECT_EQ(cache.stats().misses, 1U);
+        expect_matches_reader(tokens, text);
+        EXPECT_EQ(tokens.text(1), " ");
+        size_t quoted = 0;
+        while (tokens.kind(quoted) != token_kind::string) {
+            ++quoted;
+        }
+        EXPECT_EQ(tokens.text(quoted), "\"a\\\"b\"");
+        EXPECT_EQ(tokens.length(tokens.size() - 1), 0);
+    }
+    token_cache cache { directory };
+    const auto tokens = cache.tokens_of(text);
+    EXPECT_EQ(cache.stats().hits, 1U);
+    EXPECT_EQ(cache.stats().misses, 0U);
+    expect_matches_reader(tokens, text);
+    EXPECT_EQ(entry_count(directory), 1U);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TokenCacheTest, EvictsLeastRecentlyUsed) {
+    const auto directory = fresh_directory("qpiler_cache_eviction");
+    std::uintmax_t entry_size = 0;
+    {
+        token_cache probe { directory };
+        (void)probe.tokens_of("a = 1;");
+        entry_size = std::filesystem::directory_iterator(directory)
+                         ->file_size();
+    }
+    token_cache cache { directory, 2 * entry_size };
+    for (const auto* text : { "b = 2;", "a = 1;", "c = 3;" }) {
+        // file times must differ for the order to be visible
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        (void)cache.tokens_of(text);
+    }
+    EXPECT_EQ(entry_count(directory), 2U);
+    (void)cache.tokens_of("a = 1;");
+    (void)cache.tokens_of("c = 3;");
+    EXPECT_EQ(cache.stats().hits, 3U);
+    (void)cache.tokens_of("b = 2;");
+    EXPECT_EQ(cache.stats().misses, 3U);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TokenCacheTest, RelexesDamagedEntries) {
+    const auto directory = fresh_directory("qpiler_cache_damaged");
+    const std::string text = "x = 1.5;";
+    token_cache cache { directory };
+    (void)cache.tokens_of(text);
+    const auto entry = std::filesystem::directory_iterator(directory)->path();
+    std::filesystem::resize_file(entry, 20);
+    const auto tokens = cache.tokens_of(text);
+    EXPECT_EQ(cache.stats().misses, 2U);
+    expect_matches_reader(tokens, text);
+    EXPECT_GT(std::filesystem::file_size(entry), 20U);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TokenCacheTest, RelexesEntriesWithBadRecords) {
+    const auto directory = fresh_directory("qpiler_cache_records");
+    const std::string text = "x = 1.5;";
+    token_cache cache { directory };
+    (void)cache.tokens_of(text);
+    const auto entry = std::filesystem::directory_iterator(directory)->path();
+    std::string image;
+    {
+        std::ifstream in(entry, std::ios::binary);
+        image.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    // 7 tokens and one literal: offsets from byte 40, literal token and bits
+    // from 96, then kinds from 112, keywords from 119 and the tag at 126
+    ASSERT_EQ(image.size(), 127U);
+    const struct {
+        size_t at;
+        char byte;
+    } damage[] = {
+        { 47, '\x7f' }, // first offset far past the text
+        { 56, 9 }, // third offset past the text
+        { 112 + 2, 42 }, // kind out of range
+        { 112 + 4, 4 }, // the literal now on a keyword
+        { 112 + 1, 0 }, // eof before the end
+        { 119 + 2, 3 }, // keyword kind on an operator
+        { 126, 0 }, // no such literal tag
+    };
+    size_t misses = 1;
+    for (const auto& [at, byte] : damage) {
+        SCOPED_TRACE(at);
+        auto broken = image;
+        broken[at] = byte;
+        {
+            std::ofstream out(entry, std::ios::binary | std::ios::trunc);
+            out << broken;
+        }
+        const auto tokens = cache.tokens_of(text);
+        EXPECT_EQ(cache.stats().misses, ++misses);
+        expect_matches_reader(tokens, text);
+    }
+    (void)cache.tokens_of(text);
+    EXPECT_EQ(cache.stats().hits, 1U);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TokenCacheTest, LexingErrorsStoreNothing) {
+    const auto directory = fresh_directory("qpiler_cache_errors");
+    token_cache cache { directory };
+    EXPECT_THROW((void)cache.tokens_of("s = \"open"), std::runtime_error);
+    EXPECT_EQ(entry_count(directory), 0U);
+    std::filesystem::remove_all(directory);
+}
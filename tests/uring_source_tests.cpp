@@ -0,0 +1,92 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Yaroslav Riabtsev <yaroslav.riabtsev@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "uring_source.hpp"
+
+#include <gtest/gtest.h>
+
+#include <iomanip>
+
+#include "reader.hpp"
+
+static std::string data_path(const int index) {
+    std::ostringstream path;
+    path << "test_data/test" << std::setfill('0') << std::setw(2) << index
+         << ".qc";
+    return path.str();
+}
+
+TEST(UringSourceTest, FetchesLikeFileSource) {
+    const auto ring = io_ring::create();
+    if (!ring) {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    const std::filesystem::path path = data_path(4);
+    std::ifstream ifs(path, std::ios::binary);
+    const std::string expected(std::istreambuf_iterator<char>(ifs), {});
+
+    uring_source src { path, ring, 7 };
+    EXPECT_EQ(src.size(), static_cast<std::streamoff>(expected.size()));
+    EXPECT_TRUE(src.is_open());
+    std::string got;
+    for (auto window = src.fetch(0); !window.empty();
+         window = src.fetch(static_cast<std::streamoff>(got.size()))) {
+        EXPECT_LE(window.size(), 7u);
+        got += window;
+    }
+    EXPECT_EQ(got, expected);
+    EXPECT_TRUE(src.eof());
+    EXPECT_EQ(src.fetch(3), expected.substr(3, 7));
+    EXPECT_EQ(src.fetch(10), expected.substr(10, 7));
+    EXPECT_EQ(src.fetch(1), expected.substr(1, 7));
+}
+
+TEST(UringSourceTest, BatchMatchesBuffered) {
+    std::vector<std::filesystem::path> paths;
+    for (int i = 0; i < 12; ++i) {
+        paths.emplace_back(data_path(i));
+    }
+    const auto sources = open_uring_batch(paths, 16);
+    ASSERT_EQ(sources.size(), paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        reader buffered { paths[i], read_mode::buffered, 16 };
+        reader batched { sources[i] };
+        token expected, t;
+        do {
+            buffered.next_token(expected);
+            batched.next_token(t);
+            EXPECT_EQ(t.kind, expected.kind);
+            EXPECT_EQ(t.word, expected.word);
+            EXPECT_EQ(t.line, expected.line);
+            EXPECT_EQ(t.column, expected.column);
+        } while (expected.kind != token_kind::eof);
+        EXPECT_NO_THROW(batched.interrupt());
+    }
+}
+
+TEST(UringSourceTest, FallsBackWithoutRing) {
+    const auto src = make_uring_source(data_path(0), nullptr, 16);
+    EXPECT_NE(dynamic_cast<file_source*>(src.get()), nullptr);
+    EXPECT_THROW(uring_source(data_path(0), nullptr), std::invalid_argument);
+}